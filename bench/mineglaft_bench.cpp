@@ -0,0 +1,1019 @@
+// ================================
+// MINEGLAFT BENCHMARK
+// ================================
+// Misura senza finestra né contesto OpenGL i percorsi critici del motore:
+// generazione dei chunk, generazione delle mesh (senza caricamento sulla GPU)
+// e salvataggio/caricamento su disco. Il risultato è un oggetto JSON su stdout.
+// Verifica inoltre che la generazione sul pool di thread produca esattamente gli stessi
+// blocchi di quella sequenziale, che il rumore a blocchi (SIMD) coincida esattamente con quello
+// scalare (i chunk salvati come differenze vengono rigenerati sulla CPU di chi li apre, quindi
+// ogni set di istruzioni deve produrre gli stessi blocchi), che le mesh greedy coprano esattamente la stessa area
+// di quelle a facce singole, che il formato compatto su disco restituisca gli stessi blocchi
+// che le modifiche rimaste solo nel journal vengano ripristinate alla riapertura del mondo
+// che un chunk salvato come differenze dal chunk rigenerato torni identico e che l'apertura
+// di un mondo carichi solo l'area visibile dalla camera, con un indice dei chunk salvati
+// coerente con i file di regione:
+// in caso contrario termina con codice di errore.
+//
+// Uso: mineglaft_bench [--seed N] [--radius R] [--threads T]
+//   --seed    seed del mondo (predefinito 1)
+//   --radius  raggio della griglia di chunk, (2R+1)^2 chunk (predefinito RENDER_DISTANCE)
+//   --threads thread del pool di generazione (predefinito: uno per core, almeno 2)
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../engine/Core.h"
+#include "../engine/PerlinNoise.h"
+#include "../engine/Chunk.h"
+#include "../engine/ChunkCodec.h"
+#include "../engine/ChunkGenerationPool.h"
+#include "../engine/EditJournal.h"
+#include "../engine/RegionFile.h"
+#include "../engine/World.h"
+
+namespace fs = std::filesystem;
+
+// Campioni del microbenchmark del rumore
+const int NOISE_SAMPLES = 1 << 16;
+const int NOISE_ROUNDS = 16;
+
+using BenchClock = std::chrono::steady_clock;
+
+// Secondi trascorsi da start
+static double secondsSince(BenchClock::time_point start)
+{
+   return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+static double perSecond(double amount, double seconds)
+{
+   return seconds > 0.0 ? amount / seconds : 0.0;
+}
+
+// Vero se i due chunk hanno gli stessi blocchi, la stessa heightmap e gli stessi limiti verticali
+static bool sameBlocks(const Chunk &a, const Chunk &b)
+{
+   std::vector<uint8_t> idsA(CHUNK_VOLUME), idsB(CHUNK_VOLUME);
+   a.copyToIds(idsA.data());
+   b.copyToIds(idsB.data());
+   return idsA == idsB && a.heightMap == b.heightMap && a.minY == b.minY && a.maxY == b.maxY;
+}
+
+// Risultato del microbenchmark del rumore per un set di istruzioni
+struct NoiseResult
+{
+   NoiseIsa isa;
+   double samplesPerSec;
+   float maxError;
+};
+
+// Misura getNoiseBatch con ogni set di istruzioni supportato, su coordinate simili a quelle
+// della generazione (anche negative), e ne confronta i valori con getNoise
+static std::vector<NoiseResult> benchNoise(const PerlinNoise &noise)
+{
+   std::vector<float> xs(NOISE_SAMPLES), zs(NOISE_SAMPLES), expected(NOISE_SAMPLES), out(NOISE_SAMPLES);
+   for (int i = 0; i < NOISE_SAMPLES; i++)
+   {
+      xs[i] = (i % 256 - 128) * 0.037f;
+      zs[i] = (i / 256 - 128) * 0.013f;
+      expected[i] = noise.getNoise(xs[i], 0.0f, zs[i]);
+   }
+
+   std::vector<NoiseResult> results;
+   for (NoiseIsa isa : {NoiseIsa::SCALAR, NoiseIsa::SSE41, NoiseIsa::AVX2})
+   {
+      if (!PerlinNoise::isaSupported(isa))
+         continue;
+
+      auto start = BenchClock::now();
+      for (int round = 0; round < NOISE_ROUNDS; round++)
+         noise.getNoiseBatch(xs.data(), 0.0f, zs.data(), out.data(), NOISE_SAMPLES, isa);
+      double seconds = secondsSince(start);
+
+      float maxError = 0.0f;
+      for (int i = 0; i < NOISE_SAMPLES; i++)
+      {
+         // Un NaN conta come differenza infinita invece di sparire nel massimo
+         float difference = std::abs(out[i] - expected[i]);
+         maxError = std::max(maxError, std::isnan(difference) ? std::numeric_limits<float>::infinity() : difference);
+      }
+
+      results.push_back({isa, perSecond(static_cast<double>(NOISE_SAMPLES) * NOISE_ROUNDS, seconds), maxError});
+   }
+   return results;
+}
+
+// Risultato della codifica compatta di tutti i chunk, con o senza passaggio LZ
+struct EncodeResult
+{
+   double encodeSeconds;
+   double decodeSeconds;
+   size_t bytes;
+   bool identical; // Ogni chunk decodificato coincide con l'originale
+};
+
+static EncodeResult benchEncoding(const std::vector<Chunk> &chunks, bool compress)
+{
+   EncodeResult result = {};
+   std::vector<std::vector<char>> encoded(chunks.size());
+   auto start = BenchClock::now();
+   for (size_t i = 0; i < chunks.size(); i++)
+      ChunkCodec::encode(chunks[i], encoded[i], compress);
+   result.encodeSeconds = secondsSince(start);
+
+   std::vector<Chunk> decoded;
+   for (const Chunk &chunk : chunks)
+      decoded.emplace_back(chunk.pos);
+   result.identical = true;
+   start = BenchClock::now();
+   for (size_t i = 0; i < chunks.size(); i++)
+      result.identical = ChunkCodec::decode(encoded[i].data(), encoded[i].size(), decoded[i]) && result.identical;
+   result.decodeSeconds = secondsSince(start);
+
+   for (size_t i = 0; i < chunks.size(); i++)
+   {
+      result.bytes += encoded[i].size();
+      result.identical = result.identical && sameBlocks(chunks[i], decoded[i]);
+   }
+   return result;
+}
+
+// Risultato della generazione delle mesh di tutti i chunk con una modalità
+struct MeshResult
+{
+   double seconds;
+   size_t vertices;
+   double area; // Somma delle aree dei quadrilateri, in facce di blocco
+};
+
+// borders: strati dei vicini di ogni chunk (stesso ordine di chunks), nullptr per ignorarli
+static MeshResult benchMesh(std::vector<Chunk> &chunks, MeshingMode mode, const std::vector<ChunkBorder> *borders)
+{
+   MeshResult result = {};
+   auto start = BenchClock::now();
+   for (size_t i = 0; i < chunks.size(); i++)
+      chunks[i].generateMesh(mode, borders ? &(*borders)[i] : nullptr);
+   result.seconds = secondsSince(start);
+
+   // Le coordinate di ripetizione (s,t) di ogni quadrilatero vanno da 0 alle sue dimensioni in blocchi
+   for (const Chunk &chunk : chunks)
+   {
+      result.vertices += chunk.meshVertexCount();
+      for (const SectionMesh &mesh : chunk.meshSections)
+      {
+         for (size_t quad = 0; quad < mesh.data.size(); quad += 4 * MESH_VERTEX_WORDS)
+         {
+            uint32_t sizeS = 0, sizeT = 0;
+            for (int corner = 0; corner < 4; corner++)
+            {
+               uint32_t repeat = mesh.data[quad + corner * MESH_VERTEX_WORDS + 1];
+               sizeS = std::max(sizeS, repeat >> MESH_S_SHIFT & MESH_REPEAT_MASK);
+               sizeT = std::max(sizeT, repeat >> MESH_T_SHIFT & MESH_REPEAT_MASK);
+            }
+            result.area += static_cast<double>(sizeS) * sizeT;
+         }
+      }
+   }
+   return result;
+}
+
+static void printMesh(const char *name, const MeshResult &result, const char *separator)
+{
+   std::printf("\"%s\": { \"seconds\": %.6f, \"vertices\": %zu, \"vertex_bytes\": %zu, \"quads_per_sec\": %.1f }%s",
+               name, result.seconds, result.vertices, result.vertices * MESH_VERTEX_BYTES,
+               perSecond(static_cast<double>(result.vertices / 4), result.seconds), separator);
+}
+
+// Risultato di una sequenza di frame di streaming
+struct StreamResult
+{
+   int frames;
+   double seconds;
+   double maxFrameSeconds;
+};
+
+// Chiama updateVisibleChunks una volta per "frame" finché tutta l'area visibile è caricata
+static StreamResult streamUntilLoaded(World &world, int renderDistance)
+{
+   StreamResult result = {};
+   auto start = BenchClock::now();
+   while (result.frames < 100000)
+   {
+      auto frameStart = BenchClock::now();
+      world.updateVisibleChunks(world.camera, renderDistance);
+      result.maxFrameSeconds = std::max(result.maxFrameSeconds, secondsSince(frameStart));
+      result.frames++;
+      if (world.isVisibleAreaLoaded())
+         break;
+      if (world.pendingLoadCount() == 0)
+         std::this_thread::yield(); // In attesa del pool di generazione
+   }
+   result.seconds = secondsSince(start);
+   return result;
+}
+
+// Dimensione dei file di regione di un mondo (zero se non ne ha ancora scritto nessuno)
+static uintmax_t regionBytes(const std::string &worldName)
+{
+   uintmax_t bytes = 0;
+   std::error_code error;
+   for (const auto &entry : fs::directory_iterator(fs::path("worlds") / worldName / "region", error))
+      bytes += entry.file_size();
+   return bytes;
+}
+
+struct ExploreResult
+{
+   size_t chunks = 0; // Chunk caricati o generati durante l'esplorazione
+   uint64_t chunksWritten = 0;
+   uintmax_t bytes = 0; // Dimensione delle regioni alla fine
+};
+
+// Nuovo mondo esplorato attraversando crossings bordi di chunk, senza modifiche; a fine
+// esplorazione la coda viene svuotata e si misura quanto è finito su disco
+static ExploreResult explore(const std::string &worldName, int seed, ChunkPersistence persistence, int renderDistance, int crossings)
+{
+   World world;
+   world.generationSeed = seed;
+   world.chunkPersistence = persistence;
+   world.initializeWorld(worldName);
+   world.camera.reset();
+   world.camera.pos = Point3D(0.5f * CHUNK_SIZE, world.camera.pos.y, 0.5f * CHUNK_SIZE);
+
+   ExploreResult result;
+   streamUntilLoaded(world, renderDistance);
+   result.chunks = world.chunksMap.size();
+   for (int i = 0; i < crossings; i++)
+   {
+      world.camera.pos.x += CHUNK_SIZE;
+      streamUntilLoaded(world, renderDistance);
+      result.chunks += 2 * renderDistance + 1;
+   }
+   world.flushSaves();
+   result.chunksWritten = world.saveStats().chunksWritten;
+   result.bytes = regionBytes(worldName);
+   return result;
+}
+
+static void printStream(const char *name, const StreamResult &result, const char *separator)
+{
+   std::printf("\"%s\": { \"frames\": %d, \"seconds\": %.6f, \"max_frame_ms\": %.3f }%s",
+               name, result.frames, result.seconds, result.maxFrameSeconds * 1000.0, separator);
+}
+
+int main(int argc, char **argv)
+{
+   int seed = 1;
+   int radius = RENDER_DISTANCE;
+   int threads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+
+   for (int i = 1; i < argc; i++)
+   {
+      std::string arg = argv[i];
+      if (arg == "--seed" && i + 1 < argc)
+      {
+         seed = std::stoi(argv[++i]);
+      }
+      else if (arg == "--radius" && i + 1 < argc)
+      {
+         radius = std::stoi(argv[++i]);
+      }
+      else if (arg == "--threads" && i + 1 < argc)
+      {
+         threads = std::stoi(argv[++i]);
+      }
+      else
+      {
+         std::cerr << "Uso: mineglaft_bench [--seed N] [--radius R] [--threads T]" << std::endl;
+         return EXIT_FAILURE;
+      }
+   }
+
+   // Atlas fittizio con la stessa disposizione di textures/textures.png (6 colonne, una riga per tipo)
+   atlasWidth = 6 * textureCellSize;
+   atlasHeight = static_cast<int>(BlockType::BLOCK_COUNT) * textureCellSize;
+
+   std::vector<Chunk> chunks;
+   for (int i = -radius; i <= radius; ++i)
+      for (int j = -radius; j <= radius; ++j)
+         chunks.emplace_back(Point2D(i, j));
+   const double chunkCount = static_cast<double>(chunks.size());
+
+   // Rumore a blocchi con ciascun set di istruzioni
+   PerlinNoise noise(seed);
+   std::vector<NoiseResult> noiseResults = benchNoise(noise);
+   bool noiseAccurate = true;
+   for (const NoiseResult &result : noiseResults)
+      if (result.maxError != 0.0f)
+         noiseAccurate = false;
+
+   // Generazione del terreno
+   auto start = BenchClock::now();
+   for (Chunk &chunk : chunks)
+      chunk.generate(noise);
+   double generateSeconds = secondsSince(start);
+
+   // Generazione sul pool di thread: stessi chunk, confrontati bit per bit con quelli sequenziali
+   std::vector<Chunk> pooled;
+   double poolSeconds = 0.0;
+   {
+      ChunkGenerationPool pool(seed, threads);
+      start = BenchClock::now();
+      for (const Chunk &chunk : chunks)
+         pool.request(chunk.pos);
+      pool.waitIdle();
+      pool.collect(pooled);
+      poolSeconds = secondsSince(start);
+   }
+
+   std::unordered_map<Point2D, const Chunk *> pooledByPos;
+   for (const Chunk &chunk : pooled)
+      pooledByPos[chunk.pos] = &chunk;
+   bool poolIdentical = pooled.size() == chunks.size();
+   for (const Chunk &chunk : chunks)
+   {
+      auto it = pooledByPos.find(chunk.pos);
+      if (it == pooledByPos.end() || !sameBlocks(chunk, *it->second))
+         poolIdentical = false;
+   }
+   pooled.clear();
+
+   size_t blockBytes = 0;
+   for (const Chunk &chunk : chunks)
+      blockBytes += chunk.blockMemoryUsage();
+
+   // Strati dei chunk confinanti, come li prepara World per nascondere le facce sul bordo
+   std::unordered_map<Point2D, const Chunk *> chunksByPos;
+   for (const Chunk &chunk : chunks)
+      chunksByPos[chunk.pos] = &chunk;
+   std::vector<ChunkBorder> borders(chunks.size());
+   const int sideOffsets[CHUNK_SIDES][2] = {{0, 1}, {0, -1}, {-1, 0}, {1, 0}};
+   start = BenchClock::now();
+   for (size_t i = 0; i < chunks.size(); i++)
+   {
+      for (int side = 0; side < CHUNK_SIDES; side++)
+      {
+         auto it = chunksByPos.find(Point2D(chunks[i].pos.x + sideOffsets[side][0], chunks[i].pos.z + sideOffsets[side][1]));
+         if (it != chunksByPos.end())
+            borders[i].setSide(side, *it->second);
+      }
+   }
+   double borderSeconds = secondsSince(start);
+
+   // Generazione delle mesh con entrambe le modalità (solo CPU: il caricamento sulla GPU non fa parte del motore)
+   MeshResult isolatedMesh = benchMesh(chunks, MeshingMode::GREEDY, nullptr);
+   MeshResult perFaceMesh = benchMesh(chunks, MeshingMode::PER_FACE, &borders);
+   MeshResult greedyMesh = benchMesh(chunks, MeshingMode::GREEDY, &borders);
+   bool meshCoverageEqual = perFaceMesh.area == greedyMesh.area;
+
+   // Modifica di un blocco: rigenerazione delle sole sezioni toccate rispetto a quella dell'intero chunk.
+   // Le mesh rigenerate per sezioni devono coincidere con quelle rigenerate da zero.
+   const int REMESH_EDITS = 512;
+   const size_t remeshChunks = std::min<size_t>(chunks.size(), 64);
+   std::vector<Chunk> sectionEdited(chunks.begin(), chunks.begin() + remeshChunks);
+   std::vector<Chunk> fullEdited(sectionEdited);
+   auto editColumnTop = [](Chunk &chunk, int i)
+   {
+      // Alternativamente toglie il blocco più alto della colonna o ne mette uno sopra
+      int x = (i * 7) % CHUNK_SIZE, z = (i * 11) % CHUNK_SIZE;
+      int top = chunk.columnHeight(x, z);
+      if (i % 2 == 0 && top >= 0)
+      {
+         chunk.set(x, top, z, BlockType::AIR);
+         return top;
+      }
+      int y = std::min(top + 1, CHUNK_HEIGHT - 1);
+      chunk.set(x, y, z, BlockType::PLANKS);
+      return y;
+   };
+   double sectionRemeshSeconds = 0.0, fullRemeshSeconds = 0.0;
+   for (int i = 0; i < REMESH_EDITS; i++)
+   {
+      size_t c = i % remeshChunks;
+      int y = editColumnTop(sectionEdited[c], i);
+      start = BenchClock::now();
+      sectionEdited[c].generateMesh(MeshingMode::GREEDY, &borders[c], Chunk::sectionsTouchedBy(y));
+      sectionRemeshSeconds += secondsSince(start);
+
+      editColumnTop(fullEdited[c], i);
+      start = BenchClock::now();
+      fullEdited[c].generateMesh(MeshingMode::GREEDY, &borders[c]);
+      fullRemeshSeconds += secondsSince(start);
+   }
+   bool sectionRemeshIdentical = true;
+   for (size_t c = 0; c < remeshChunks; c++)
+      for (int sectionIndex = 0; sectionIndex < SECTIONS_PER_CHUNK; sectionIndex++)
+         sectionRemeshIdentical = sectionRemeshIdentical &&
+                                  sectionEdited[c].meshSections[sectionIndex].data == fullEdited[c].meshSections[sectionIndex].data;
+   sectionEdited.clear();
+   fullEdited.clear();
+
+   // Formato compatto dei chunk, con e senza passaggio LZ, rispetto al vecchio formato grezzo
+   EncodeResult rleEncoding = benchEncoding(chunks, false);
+   EncodeResult lzEncoding = benchEncoding(chunks, true);
+   bool encodingIdentical = rleEncoding.identical && lzEncoding.identical;
+
+   // Salvataggio e caricamento in una cartella temporanea
+   fs::path benchDir = fs::temp_directory_path() / "mineglaft_bench";
+   fs::remove_all(benchDir);
+   fs::create_directories(benchDir);
+   fs::path previousDir = fs::current_path();
+   fs::current_path(benchDir);
+
+   // Senza differenze: i chunk salvati sono appena generati e si misura la codifica completa
+   World world;
+   world.generationSeed = seed;
+   world.deltaChunkData = false;
+   world.initializeWorld("bench_world");
+
+   start = BenchClock::now();
+   for (const Chunk &chunk : chunks)
+      world.saveChunk(chunk.pos, chunk);
+   double saveSeconds = secondsSince(start);
+
+   uintmax_t diskBytes = regionBytes("bench_world");
+
+   // Caricamento: ogni chunk deve tornare identico a quello salvato
+   size_t loaded = 0;
+   bool loadIdentical = true;
+   start = BenchClock::now();
+   for (const Chunk &chunk : chunks)
+   {
+      Chunk copy(chunk.pos);
+      if (world.loadChunk(chunk.pos, copy))
+      {
+         loaded++;
+         loadIdentical = loadIdentical && sameBlocks(chunk, copy);
+      }
+   }
+   double loadSeconds = secondsSince(start);
+   loadIdentical = loadIdentical && loaded == chunks.size();
+
+   // Riscrittura degli stessi chunk: a parità di dimensione restano al loro posto nella regione
+   for (const Chunk &chunk : chunks)
+      world.saveChunk(chunk.pos, chunk);
+   bool rewriteInPlace = regionBytes("bench_world") == diskBytes;
+
+   // Vecchio formato per confronto: un file per chunk, aperto e chiuso a ogni accesso
+   fs::path legacyDir = benchDir / "legacy";
+   fs::create_directories(legacyDir);
+   auto legacyFile = [&legacyDir](const Point2D &pos)
+   {
+      return legacyDir / ("chunk_" + std::to_string(static_cast<int>(pos.x)) + "_" + std::to_string(static_cast<int>(pos.z)) + ".dat");
+   };
+   start = BenchClock::now();
+   for (const Chunk &chunk : chunks)
+   {
+      std::ofstream out(legacyFile(chunk.pos), std::ios::binary);
+      World::writeChunkData(out, chunk);
+   }
+   double legacySaveSeconds = secondsSince(start);
+
+   uintmax_t legacyBytes = 0;
+   for (const auto &entry : fs::directory_iterator(legacyDir))
+      legacyBytes += entry.file_size();
+
+   start = BenchClock::now();
+   for (const Chunk &chunk : chunks)
+   {
+      Chunk copy(chunk.pos);
+      std::ifstream in(legacyFile(chunk.pos), std::ios::binary);
+      World::readChunkData(in, copy);
+   }
+   double legacyLoadSeconds = secondsSince(start);
+
+   // Streaming dal disco con un'area visibile più piccola della griglia salvata, così anche
+   // attraversando due bordi di chunk tutti i chunk richiesti sono già su disco
+   const int streamDistance = std::max(1, radius / 2);
+   world.camera.reset();
+   world.camera.pos = Point3D(0.5f * CHUNK_SIZE, world.camera.pos.y, 0.5f * CHUNK_SIZE);
+   StreamResult streamFill = streamUntilLoaded(world, streamDistance);
+
+   const int idleFrames = 1000;
+   start = BenchClock::now();
+   for (int i = 0; i < idleFrames; i++)
+      world.updateVisibleChunks(world.camera, streamDistance);
+   double idleFrameSeconds = secondsSince(start) / idleFrames;
+
+   // Attraversamento di un bordo con il limite di caricamenti per frame e poi senza limite
+   world.camera.pos.x += CHUNK_SIZE;
+   StreamResult streamCrossCapped = streamUntilLoaded(world, streamDistance);
+   int loadCap = world.maxChunkLoadsPerFrame;
+   world.maxChunkLoadsPerFrame = CHUNK_VOLUME;
+   world.camera.pos.x += CHUNK_SIZE;
+   StreamResult streamCrossUncapped = streamUntilLoaded(world, streamDistance);
+   world.maxChunkLoadsPerFrame = loadCap;
+   world.generationPool.reset();
+
+   // Costruzione rapida: EDIT_COUNT modifiche distribuite su pochi chunk caricati. Si confronta il costo
+   // per modifica del salvataggio sincrono con quello della coda, poi si svuota la coda e si verifica
+   // che i chunk riletti dal disco contengano tutte le modifiche.
+   const int EDIT_COUNT = 2000;
+   const int EDITED_CHUNKS = 4;
+   std::vector<Chunk *> edited;
+   for (auto &chunkPair : world.chunksMap)
+      if (static_cast<int>(edited.size()) < EDITED_CHUNKS)
+         edited.push_back(&chunkPair.second);
+   auto editBlock = [&edited](int i)
+   {
+      Chunk &chunk = *edited[i % edited.size()];
+      BlockType type = (i / 7) % 2 ? BlockType::BRICKS : BlockType::PLANKS;
+      chunk.set((i * 5) % CHUNK_SIZE, 100 + (i * 3) % 40, (i * 11) % CHUNK_SIZE, type);
+      return &chunk;
+   };
+   world.flushSaves();
+   start = BenchClock::now();
+   for (int i = 0; i < EDIT_COUNT; i++)
+   {
+      Chunk *chunk = editBlock(i);
+      world.saveChunk(chunk->pos, *chunk);
+   }
+   double syncEditSeconds = secondsSince(start);
+
+   ChunkSaveQueue::Stats statsBefore = world.saveStats();
+   start = BenchClock::now();
+   for (int i = 0; i < EDIT_COUNT; i++)
+      world.markChunkDirty(*editBlock(EDIT_COUNT + i));
+   double queuedEditSeconds = secondsSince(start);
+   size_t queueDepth = world.saveStats().queued;
+   start = BenchClock::now();
+   world.flushSaves();
+   double flushSeconds = secondsSince(start);
+   ChunkSaveQueue::Stats statsAfter = world.saveStats();
+
+   bool editsPersisted = statsAfter.queued == 0;
+   for (Chunk *chunk : edited)
+   {
+      Chunk copy(chunk->pos);
+      editsPersisted = editsPersisted && world.loadChunk(chunk->pos, copy) && sameBlocks(*chunk, copy);
+   }
+
+   // Esplorazione senza modifiche salvando tutti i chunk generati o solo quelli modificati
+   const int EXPLORE_CROSSINGS = 4;
+   ExploreResult exploreAll = explore("explore_all", seed, ChunkPersistence::ALL, streamDistance, EXPLORE_CROSSINGS);
+   ExploreResult exploreModified = explore("explore_modified", seed, ChunkPersistence::MODIFIED, streamDistance, EXPLORE_CROSSINGS);
+
+   // Poche modifiche a un chunk mai salvato: finisce su disco come differenze dal chunk rigenerato
+   // e deve tornare identico; un chunk non modificato non viene scritto
+   const int DELTA_EDITS = 64;
+   size_t deltaBytes = 0, fullBytes = 0;
+   uint64_t deltaChunksWritten = 0;
+   bool deltaIdentical = exploreModified.chunksWritten == 0;
+   Chunk savedDelta;
+   {
+      World deltaWorld;
+      deltaWorld.generationSeed = seed;
+      deltaWorld.initializeWorld("delta_world");
+      streamUntilLoaded(deltaWorld, 1);
+      // Fuori dal chunk della camera, così alla riapertura arriva dal pool di generazione
+      const Point2D editedPos(1, 0);
+      for (int i = 0; i < DELTA_EDITS; i++)
+      {
+         Point3D blockPos(editedPos.x * CHUNK_SIZE + (i * 5) % CHUNK_SIZE, 100 + (i * 7) % 50, editedPos.z * CHUNK_SIZE + (i * 3) % CHUNK_SIZE);
+         deltaWorld.placeBlock(blockPos, i % 2 ? BlockType::BRICKS : BlockType::PLANKS);
+      }
+      deltaWorld.flushSaves();
+      deltaChunksWritten = deltaWorld.saveStats().chunksWritten;
+
+      const Chunk &editedChunk = deltaWorld.chunksMap.at(editedPos);
+      Chunk baseline(editedPos);
+      baseline.generate(PerlinNoise(seed));
+      std::vector<char> bytes;
+      ChunkCodec::DeltaBaseline origin;
+      origin.seed = seed;
+      ChunkCodec::encodeDelta(editedChunk, baseline, origin, bytes);
+      deltaBytes = bytes.size();
+
+      // Le differenze non vanno applicate a un terreno di un altro seed o di un altro generatore
+      ChunkCodec::DeltaBaseline otherSeed = origin, otherGenerator = origin;
+      otherSeed.seed++;
+      otherGenerator.generator++;
+      Chunk mismatched = baseline;
+      deltaIdentical = deltaIdentical && !ChunkCodec::decodeDelta(bytes.data(), bytes.size(), otherSeed, mismatched) &&
+                       !ChunkCodec::decodeDelta(bytes.data(), bytes.size(), otherGenerator, mismatched) &&
+                       sameBlocks(baseline, mismatched);
+      ChunkCodec::encode(editedChunk, bytes);
+      fullBytes = bytes.size();
+
+      Chunk copy(editedPos), untouched(Point2D(-1, 0));
+      deltaIdentical = deltaIdentical && deltaChunksWritten == 1 && deltaWorld.loadChunk(editedPos, copy) &&
+                       sameBlocks(editedChunk, copy) && !deltaWorld.loadChunk(untouched.pos, untouched);
+      savedDelta = editedChunk;
+   }
+   {
+      // Riaprendo il mondo le differenze vengono applicate dal pool al chunk rigenerato
+      World reopened;
+      reopened.loadWorld("delta_world", 1);
+      streamUntilLoaded(reopened, 1);
+      auto restored = reopened.chunksMap.find(savedDelta.pos);
+      deltaIdentical = deltaIdentical && restored != reopened.chunksMap.end() && sameBlocks(savedDelta, restored->second);
+   }
+   {
+      // Un mondo esistente non viene sostituito senza replaceExisting, né toccato da nomi che
+      // escono dalla cartella dei mondi; sostituito, il mondo nuovo con un altro seed non riusa
+      // le differenze salvate
+      World replaced;
+      replaced.generationSeed = seed + 1;
+      bool refused = !replaced.initializeWorld("delta_world") && fs::exists(fs::path("worlds") / "delta_world" / "region");
+      const std::string absoluteName = (benchDir / "absolute_world").string();
+      for (const std::string &name : {std::string(), std::string("."), std::string(".."), std::string("../delta_world"),
+                                      absoluteName, std::string("a/b"), std::string("a\\b")})
+         refused = refused && !World::isValidWorldName(name) && !replaced.initializeWorld(name, true) && !replaced.loadWorld(name, 0);
+      Chunk stale(Point2D(0, 0));
+      deltaIdentical = deltaIdentical && refused && replaced.initializeWorld("delta_world", true) &&
+                       replaced.storedChunkCount() == 0 && !replaced.loadChunk(stale.pos, stale);
+   }
+
+   // Avvio di un mondo nuovo: griglia completa prima del primo frame (come in passato) oppure
+   // solo l'anello attorno alla camera, con il resto dell'area generato frame dopo frame
+   double gridStartupSeconds, firstFrameSeconds, fullAreaSeconds;
+   {
+      World gridWorld;
+      gridWorld.generationSeed = seed;
+      gridWorld.initializeWorld("startup_grid");
+      start = BenchClock::now();
+      gridWorld.generateChunkGrid(radius);
+      gridWorld.resetCamera();
+      gridWorld.updateVisibleChunks(gridWorld.camera, radius);
+      gridStartupSeconds = secondsSince(start);
+
+      World progressive;
+      progressive.generationSeed = seed;
+      progressive.initializeWorld("startup_progressive");
+      start = BenchClock::now();
+      progressive.generateChunkGrid(1);
+      progressive.resetCamera();
+      progressive.updateVisibleChunks(progressive.camera, radius);
+      firstFrameSeconds = secondsSince(start);
+      streamUntilLoaded(progressive, radius);
+      fullAreaSeconds = secondsSince(start);
+   }
+
+   // Meshing sul pool: lo stesso mondo generato con le mesh sul thread principale e sul pool.
+   // Con il pool il thread principale copia solo blocchi e bordi, quindi i frame restano brevi mentre
+   // i chunk arrivano; completate le mesh, le sezioni devono coincidere con quelle del thread principale.
+   StreamResult syncMeshStream, asyncMeshStream;
+   double asyncMeshWaitSeconds;
+   int meshThreads;
+   bool asyncMeshIdentical = true;
+   {
+      World syncWorld;
+      syncWorld.generationSeed = seed;
+      syncWorld.asyncMeshing = false;
+      syncWorld.initializeWorld("mesh_sync");
+      syncWorld.resetCamera();
+      syncMeshStream = streamUntilLoaded(syncWorld, radius);
+
+      World asyncWorld;
+      asyncWorld.generationSeed = seed;
+      asyncWorld.initializeWorld("mesh_async");
+      asyncWorld.resetCamera();
+      asyncMeshStream = streamUntilLoaded(asyncWorld, radius);
+      start = BenchClock::now();
+      asyncWorld.waitForMeshes();
+      asyncMeshWaitSeconds = secondsSince(start);
+      meshThreads = asyncWorld.mesher().threadCount();
+
+      asyncMeshIdentical = syncWorld.chunksMap.size() == asyncWorld.chunksMap.size();
+      for (const auto &chunkPair : syncWorld.chunksMap)
+      {
+         auto it = asyncWorld.chunksMap.find(chunkPair.first);
+         if (it == asyncWorld.chunksMap.end())
+         {
+            asyncMeshIdentical = false;
+            continue;
+         }
+         for (int sectionIndex = 0; sectionIndex < SECTIONS_PER_CHUNK; sectionIndex++)
+            asyncMeshIdentical = asyncMeshIdentical &&
+                                 chunkPair.second.meshSections[sectionIndex].data == it->second.meshSections[sectionIndex].data;
+      }
+   }
+
+   // Apertura pigra: lo stesso mondo con i chunk della griglia e poi con LAZY_COPIES copie lontane
+   // della griglia. Vengono caricati solo i chunk entro streamDistance dalla camera, quindi il tempo
+   // di apertura non deve crescere con i chunk salvati.
+   const int LAZY_COPIES = 8;
+   double lazySmallSeconds, lazyLargeSeconds;
+   size_t lazySmallChunks, lazyLargeChunks;
+   {
+      World lazyWorld;
+      lazyWorld.generationSeed = seed;
+      lazyWorld.deltaChunkData = false;
+      lazyWorld.initializeWorld("lazy_world");
+      for (const Chunk &chunk : chunks)
+         lazyWorld.saveChunk(chunk.pos, chunk);
+
+      auto timeLoad = [streamDistance](size_t &loadedChunks)
+      {
+         World opened;
+         auto loadStart = BenchClock::now();
+         opened.loadWorld("lazy_world", streamDistance);
+         double seconds = secondsSince(loadStart);
+         loadedChunks = opened.chunksMap.size();
+         return seconds;
+      };
+      lazySmallSeconds = timeLoad(lazySmallChunks);
+
+      for (int copy = 1; copy <= LAZY_COPIES; copy++)
+         for (const Chunk &chunk : chunks)
+            lazyWorld.saveChunk(Point2D(chunk.pos.x + copy * 1000, chunk.pos.z), chunk);
+      lazyLargeSeconds = timeLoad(lazyLargeChunks);
+   }
+
+   // Aprire un mondo da uno già aperto con un altro seed non deve toccare il world.info del primo
+   bool previousInfoKept;
+   {
+      World switching;
+      switching.generationSeed = seed + 1;
+      switching.initializeWorld("switch_world");
+      switching.loadWorld("lazy_world", 0);
+      std::ifstream switchInfo(fs::path("worlds") / "switch_world" / "world.info");
+      std::string token;
+      int switchSeed = 0;
+      switchInfo >> token >> switchSeed;
+      previousInfoKept = switchSeed == seed + 1 && switching.generationSeed == seed;
+   }
+
+   // Indice dei chunk salvati: un chunk mai salvato (qui uno per regione, lontano da tutti) viene
+   // scartato senza toccare il disco, mentre prima ogni nuova regione costava un tentativo di
+   // apertura del suo file. Riaprendo il mondo l'indice viene letto dal manifest, oppure
+   // ricostruito dalle regioni se il manifest manca.
+   const int MISSING_LOOKUPS = 4096;
+   const size_t lazyStored = chunks.size() * (LAZY_COPIES + 1);
+   double missingLookupSeconds, regionProbeSeconds;
+   size_t manifestLoaded, manifestRebuilt;
+   bool manifestConsistent = true;
+   {
+      World indexed;
+      indexed.loadWorld("lazy_world", 0);
+      manifestLoaded = indexed.storedChunkCount();
+      start = BenchClock::now();
+      for (int i = 0; i < MISSING_LOOKUPS; i++)
+      {
+         Chunk missing(Point2D(i * RegionFile::REGION_SIZE, 100000));
+         manifestConsistent = manifestConsistent && !indexed.loadChunk(missing.pos, missing);
+      }
+      missingLookupSeconds = secondsSince(start);
+
+      start = BenchClock::now();
+      for (int i = 0; i < MISSING_LOOKUPS; i++)
+      {
+         Point2D regionPos = RegionFile::regionOf(Point2D(i * RegionFile::REGION_SIZE, 100000));
+         RegionFile probe((fs::path("worlds") / "lazy_world" / "region" / RegionFile::fileName(regionPos)).string(), regionPos);
+         manifestConsistent = manifestConsistent && !probe.contains(Point2D(i * RegionFile::REGION_SIZE, 100000));
+      }
+      regionProbeSeconds = secondsSince(start);
+   }
+   fs::remove(fs::path("worlds") / "lazy_world" / "chunks.manifest");
+   {
+      World rebuilt;
+      rebuilt.loadWorld("lazy_world", 0);
+      manifestRebuilt = rebuilt.storedChunkCount();
+   }
+   manifestConsistent = manifestConsistent && manifestLoaded == lazyStored && manifestRebuilt == lazyStored;
+
+   // File di regione aperti: con un limite di 2 le LAZY_COPIES + 1 regioni del mondo vengono chiuse
+   // e riaperte a turno, senza perdere chunk. Un file di regione con la tabella troncata non
+   // viene ricreato (né svuotato) alla scrittura successiva.
+   const size_t OPEN_REGION_LIMIT = 2;
+   size_t openRegionsMax = 0;
+   bool regionsIntact = true;
+   {
+      World bounded;
+      bounded.maxOpenRegions = OPEN_REGION_LIMIT;
+      bounded.loadWorld("lazy_world", 0);
+      for (int copy = 0; copy <= LAZY_COPIES; copy++)
+         for (const Chunk &chunk : chunks)
+         {
+            Chunk copied(Point2D(chunk.pos.x + copy * 1000, chunk.pos.z));
+            regionsIntact = regionsIntact && bounded.loadChunk(copied.pos, copied) && sameBlocks(chunk, copied);
+            openRegionsMax = std::max(openRegionsMax, bounded.openRegionCount());
+         }
+   }
+   {
+      fs::path damagedPath = fs::path("worlds") / "damaged_region.mgr";
+      {
+         std::ofstream damaged(damagedPath, std::ios::binary);
+         damaged << "MGR";
+      }
+      RegionFile damaged(damagedPath.string(), Point2D(0, 0));
+      const char data[4] = {1, 2, 3, 4};
+      regionsIntact = regionsIntact && !damaged.write(Point2D(0, 0), data, sizeof(data)) && fs::file_size(damagedPath) == 3;
+   }
+   const size_t lazyArea = static_cast<size_t>(2 * streamDistance + 1) * (2 * streamDistance + 1);
+   bool lazyBounded = lazySmallChunks == lazyArea && lazyLargeChunks == lazyArea;
+
+   // Journal: costo di una modifica registrata (copia in memoria) e dei fsync a lotti
+   double journalAppendSeconds, journalSyncSeconds;
+   {
+      EditJournal journal((benchDir / "journal_bench").string(), std::chrono::hours(1));
+      start = BenchClock::now();
+      for (int i = 0; i < EDIT_COUNT; i++)
+         journal.append({i, -i, i % CHUNK_HEIGHT, BlockType::AIR, BlockType::STONE});
+      journalAppendSeconds = secondsSince(start);
+      start = BenchClock::now();
+      journal.sync();
+      journalSyncSeconds = secondsSince(start);
+   }
+   bool journalReadBack = EditJournal::readAll((benchDir / "journal_bench").string()).size() == static_cast<size_t>(EDIT_COUNT);
+
+   // Ripristino: modifiche registrate nel journal ma non ancora nelle regioni (la coda non scrive),
+   // poi la cartella del mondo viene copiata come la lascerebbe un'interruzione e riaperta
+   bool journalRecovered = journalReadBack;
+   {
+      World crashed;
+      crashed.generationSeed = seed;
+      crashed.saveFlushInterval = std::chrono::hours(1);
+      crashed.initializeWorld("journal_world");
+      for (int i = 0; i < EDITED_CHUNKS; i++)
+      {
+         crashed.chunksMap[chunks[i].pos] = chunks[i];
+         crashed.saveChunk(chunks[i].pos, chunks[i]);
+      }
+      for (int i = 0; i < EDIT_COUNT; i++)
+      {
+         const Chunk &chunk = chunks[i % EDITED_CHUNKS];
+         Point3D blockPos(chunk.pos.x * CHUNK_SIZE + (i * 7) % CHUNK_SIZE, 90 + (i * 13) % 60, chunk.pos.z * CHUNK_SIZE + (i * 3) % CHUNK_SIZE);
+         crashed.placeBlock(blockPos, (i / 5) % 2 ? BlockType::BRICKS : BlockType::AIR);
+      }
+      crashed.syncJournal();
+      fs::copy(fs::path("worlds") / "journal_world", fs::path("worlds") / "journal_crash", fs::copy_options::recursive);
+
+      World recovered;
+      journalRecovered = journalRecovered && recovered.loadWorld("journal_crash");
+      for (int i = 0; i < EDITED_CHUNKS; i++)
+      {
+         Chunk copy(chunks[i].pos);
+         journalRecovered = journalRecovered && recovered.loadChunk(copy.pos, copy) && sameBlocks(crashed.chunksMap[copy.pos], copy);
+      }
+      journalRecovered = journalRecovered && EditJournal::readAll((fs::path("worlds") / "journal_crash" / "journal").string()).empty();
+   }
+
+   fs::current_path(previousDir);
+   fs::remove_all(benchDir);
+
+   const double megabytes = static_cast<double>(diskBytes) / (1024.0 * 1024.0);
+   const double legacyMegabytes = static_cast<double>(legacyBytes) / (1024.0 * 1024.0);
+
+   std::printf("{\n");
+   std::printf("  \"seed\": %d,\n", seed);
+   std::printf("  \"radius\": %d,\n", radius);
+   std::printf("  \"chunks\": %zu,\n", chunks.size());
+   std::printf("  \"noise\": { \"best\": \"%s\", \"isa\": [", PerlinNoise::isaName(PerlinNoise::bestIsa()));
+   for (size_t i = 0; i < noiseResults.size(); i++)
+      std::printf("%s{ \"name\": \"%s\", \"samples_per_sec\": %.1f, \"max_error\": %g }", i > 0 ? ", " : " ",
+                  PerlinNoise::isaName(noiseResults[i].isa), noiseResults[i].samplesPerSec, noiseResults[i].maxError);
+   std::printf(" ] },\n");
+   std::printf("  \"generate\": { \"seconds\": %.6f, \"chunks_per_sec\": %.1f },\n",
+               generateSeconds, perSecond(chunkCount, generateSeconds));
+   std::printf("  \"pool\": { \"threads\": %d, \"seconds\": %.6f, \"chunks_per_sec\": %.1f, \"identical\": %s },\n",
+               threads, poolSeconds, perSecond(chunkCount, poolSeconds), poolIdentical ? "true" : "false");
+   std::printf("  \"mesh\": { ");
+   printMesh("per_face", perFaceMesh, ", ");
+   printMesh("greedy", greedyMesh, ", ");
+   std::printf("\"same_coverage\": %s,\n", meshCoverageEqual ? "true" : "false");
+   std::printf("    \"borders\": { \"seconds\": %.6f, \"greedy_vertices_without\": %zu, \"greedy_vertices_with\": %zu } },\n",
+               borderSeconds, isolatedMesh.vertices, greedyMesh.vertices);
+   std::printf("  \"section_remesh\": { \"edits\": %d, \"full_chunk_us\": %.3f, \"sections_us\": %.3f, \"speedup\": %.1f, \"identical\": %s },\n",
+               REMESH_EDITS, fullRemeshSeconds * 1e6 / REMESH_EDITS, sectionRemeshSeconds * 1e6 / REMESH_EDITS,
+               fullRemeshSeconds / std::max(sectionRemeshSeconds, 1e-9), sectionRemeshIdentical ? "true" : "false");
+   auto printEncoding = [chunkCount](const char *name, const EncodeResult &result, const char *suffix)
+   {
+      std::printf("\"%s\": { \"bytes_per_chunk\": %.1f, \"ratio\": %.1f, \"encode_chunks_per_sec\": %.1f, \"decode_chunks_per_sec\": %.1f }%s",
+                  name, result.bytes / chunkCount, ChunkCodec::LEGACY_BYTES * chunkCount / std::max<double>(1.0, result.bytes),
+                  perSecond(chunkCount, result.encodeSeconds), perSecond(chunkCount, result.decodeSeconds), suffix);
+   };
+   std::printf("  \"encoding\": { \"raw_bytes_per_chunk\": %zu, ", ChunkCodec::LEGACY_BYTES);
+   printEncoding("rle", rleEncoding, ", ");
+   printEncoding("rle_lz", lzEncoding, ", ");
+   std::printf("\"identical\": %s },\n", encodingIdentical ? "true" : "false");
+   std::printf("  \"save\": { \"seconds\": %.6f, \"bytes\": %ju, \"mb_per_sec\": %.1f, \"rewrite_in_place\": %s },\n",
+               saveSeconds, diskBytes, perSecond(megabytes, saveSeconds), rewriteInPlace ? "true" : "false");
+   std::printf("  \"load\": { \"seconds\": %.6f, \"chunks\": %zu, \"mb_per_sec\": %.1f, \"chunks_per_sec\": %.1f, \"identical\": %s },\n",
+               loadSeconds, loaded, perSecond(megabytes, loadSeconds), perSecond(static_cast<double>(loaded), loadSeconds),
+               loadIdentical ? "true" : "false");
+   std::printf("  \"legacy_files\": { \"save_seconds\": %.6f, \"load_seconds\": %.6f, \"bytes\": %ju, \"load_mb_per_sec\": %.1f, \"load_chunks_per_sec\": %.1f },\n",
+               legacySaveSeconds, legacyLoadSeconds, legacyBytes, perSecond(legacyMegabytes, legacyLoadSeconds), perSecond(chunkCount, legacyLoadSeconds));
+   std::printf("  \"stream\": { \"render_distance\": %d, \"loads_per_frame\": %d, \"idle_frame_us\": %.3f, ",
+               streamDistance, loadCap, idleFrameSeconds * 1e6);
+   printStream("fill", streamFill, ", ");
+   printStream("cross_capped", streamCrossCapped, ", ");
+   printStream("cross_uncapped", streamCrossUncapped, " },\n");
+   std::printf("  \"edits\": { \"count\": %d, \"chunks\": %zu, \"sync_us_per_edit\": %.3f, \"queued_us_per_edit\": %.3f, "
+               "\"queue_depth\": %zu, \"flush_seconds\": %.6f, \"chunks_written\": %ju, \"bytes_written\": %ju, \"bytes_per_sec\": %.0f, \"persisted\": %s },\n",
+               EDIT_COUNT, edited.size(), syncEditSeconds * 1e6 / EDIT_COUNT, queuedEditSeconds * 1e6 / EDIT_COUNT, queueDepth, flushSeconds,
+               static_cast<uintmax_t>(statsAfter.chunksWritten - statsBefore.chunksWritten),
+               static_cast<uintmax_t>(statsAfter.bytesWritten - statsBefore.bytesWritten), statsAfter.bytesPerSecond,
+               editsPersisted ? "true" : "false");
+   std::printf("  \"persistence\": { \"explored_chunks\": %zu, \"all\": { \"chunks_written\": %ju, \"bytes\": %ju }, "
+               "\"modified\": { \"chunks_written\": %ju, \"bytes\": %ju }, \"edit\": { \"edits\": %d, \"chunks_written\": %ju, "
+               "\"delta_bytes\": %zu, \"full_bytes\": %zu, \"identical\": %s } },\n",
+               exploreAll.chunks, static_cast<uintmax_t>(exploreAll.chunksWritten), exploreAll.bytes,
+               static_cast<uintmax_t>(exploreModified.chunksWritten), exploreModified.bytes, DELTA_EDITS,
+               static_cast<uintmax_t>(deltaChunksWritten), deltaBytes, fullBytes, deltaIdentical ? "true" : "false");
+   std::printf("  \"startup\": { \"render_distance\": %d, \"grid_first_frame_seconds\": %.6f, \"first_frame_seconds\": %.6f, \"full_area_seconds\": %.6f },\n",
+               radius, gridStartupSeconds, firstFrameSeconds, fullAreaSeconds);
+   std::printf("  \"async_mesh\": { \"render_distance\": %d, \"threads\": %d, ", radius, meshThreads);
+   printStream("sync", syncMeshStream, ", ");
+   printStream("async", asyncMeshStream, ", ");
+   std::printf("\"wait_seconds\": %.6f, \"identical\": %s },\n", asyncMeshWaitSeconds, asyncMeshIdentical ? "true" : "false");
+   std::printf("  \"lazy_load\": { \"render_distance\": %d, \"stored_small\": %zu, \"stored_large\": %zu, \"small_seconds\": %.6f, "
+               "\"large_seconds\": %.6f, \"chunks_loaded_small\": %zu, \"chunks_loaded_large\": %zu, \"bounded\": %s, "
+               "\"previous_info_kept\": %s },\n",
+               streamDistance, chunks.size(), chunks.size() * (LAZY_COPIES + 1), lazySmallSeconds, lazyLargeSeconds,
+               lazySmallChunks, lazyLargeChunks, lazyBounded ? "true" : "false", previousInfoKept ? "true" : "false");
+   std::printf("  \"manifest\": { \"stored\": %zu, \"loaded\": %zu, \"rebuilt\": %zu, \"missing_lookups_per_sec\": %.1f, "
+               "\"region_probes_per_sec\": %.1f, \"consistent\": %s },\n",
+               lazyStored, manifestLoaded, manifestRebuilt, perSecond(MISSING_LOOKUPS, missingLookupSeconds),
+               perSecond(MISSING_LOOKUPS, regionProbeSeconds), manifestConsistent ? "true" : "false");
+   std::printf("  \"regions\": { \"open_limit\": %zu, \"open_max\": %zu, \"intact\": %s },\n",
+               OPEN_REGION_LIMIT, openRegionsMax, regionsIntact ? "true" : "false");
+   std::printf("  \"journal\": { \"append_us_per_edit\": %.3f, \"sync_seconds\": %.6f, \"bytes_per_edit\": %zu, \"recovered\": %s },\n",
+               journalAppendSeconds * 1e6 / EDIT_COUNT, journalSyncSeconds, EditJournal::RECORD_BYTES, journalRecovered ? "true" : "false");
+   std::printf("  \"memory\": { \"block_bytes_per_chunk\": %.1f }\n", static_cast<double>(blockBytes) / chunkCount);
+   std::printf("}\n");
+
+   if (!poolIdentical)
+   {
+      std::cerr << "Errore: la generazione sul pool differisce da quella sequenziale." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!meshCoverageEqual)
+   {
+      std::cerr << "Errore: le mesh greedy non coprono la stessa area di quelle a facce singole." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!sectionRemeshIdentical)
+   {
+      std::cerr << "Errore: le mesh rigenerate per sezioni differiscono da quelle dell'intero chunk." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!encodingIdentical)
+   {
+      std::cerr << "Errore: i chunk decodificati dal formato compatto differiscono dagli originali." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!editsPersisted)
+   {
+      std::cerr << "Errore: le modifiche salvate dalla coda non coincidono con i chunk modificati." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!deltaIdentical)
+   {
+      std::cerr << "Errore: i chunk salvati come differenze non coincidono con quelli modificati." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!asyncMeshIdentical)
+   {
+      std::cerr << "Errore: le mesh generate sul pool differiscono da quelle del thread principale." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!lazyBounded)
+   {
+      std::cerr << "Errore: l'apertura del mondo non carica solo l'area visibile dalla camera." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!previousInfoKept)
+   {
+      std::cerr << "Errore: aprire un mondo ha modificato il world.info di quello aperto prima." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!manifestConsistent)
+   {
+      std::cerr << "Errore: l'indice dei chunk salvati non corrisponde ai file di regione." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!regionsIntact || openRegionsMax > OPEN_REGION_LIMIT)
+   {
+      std::cerr << "Errore: i file di regione aperti superano il limite o un file danneggiato è stato riscritto." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!journalRecovered)
+   {
+      std::cerr << "Errore: le modifiche registrate nel journal non sono state ripristinate." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!loadIdentical)
+   {
+      std::cerr << "Errore: i chunk caricati dai file di regione differiscono da quelli salvati." << std::endl;
+      return EXIT_FAILURE;
+   }
+   if (!noiseAccurate)
+   {
+      std::cerr << "Errore: il rumore a blocchi differisce da quello scalare." << std::endl;
+      return EXIT_FAILURE;
+   }
+   return EXIT_SUCCESS;
+}
@@ -0,0 +1,730 @@
+// ================================
+// CHUNK E SEZIONI
+// ================================
+#include "Chunk.h"
+
+#include <algorithm>
+#include <iterator>
+
+// Dimensioni dell'atlas delle texture: impostate da chi carica l'immagine (o dal benchmark)
+int atlasWidth = 0;
+int atlasHeight = 0;
+
+// ================================
+// CLASSE SEZIONE
+// ================================
+void ChunkSection::set(int localX, int sectionY, int localZ, BlockType type)
+{
+   uint8_t id = static_cast<uint8_t>(type);
+   if (isUniform())
+   {
+      if (palette[0] == id)
+         return;
+      // Primo blocco diverso: la sezione diventa un array reale (tutti indici 0)
+      bitsShift = 0;
+      data.assign(SECTION_VOLUME / 64, 0);
+   }
+
+   int paletteIndex = 0;
+   while (paletteIndex < static_cast<int>(palette.size()) && palette[paletteIndex] != id)
+      paletteIndex++;
+
+   if (paletteIndex == static_cast<int>(palette.size()))
+   {
+      // Nuovo tipo: aggiungilo alla palette e, se serve, allarga gli indici
+      palette.push_back(id);
+      if (static_cast<int>(palette.size()) > (1 << bitsPerBlock()))
+         repack(bitsShift + 1);
+   }
+   writeIndex(blockIndex(localX, sectionY, localZ), paletteIndex);
+}
+
+void ChunkSection::unpack(uint8_t *out) const
+{
+   if (isUniform())
+   {
+      std::fill(out, out + SECTION_VOLUME, palette[0]);
+      return;
+   }
+
+   int bits = bitsPerBlock();
+   int perWord = 64 / bits;
+   uint64_t mask = (1u << bits) - 1;
+   int i = 0;
+   for (uint64_t word : data)
+   {
+      for (int k = 0; k < perWord; k++, word >>= bits)
+         out[i++] = palette[word & mask];
+   }
+}
+
+void ChunkSection::pack(const uint8_t *ids)
+{
+   int remap[256];
+   std::fill(std::begin(remap), std::end(remap), -1);
+   palette.clear();
+   for (int i = 0; i < SECTION_VOLUME; i++)
+   {
+      if (remap[ids[i]] < 0)
+      {
+         remap[ids[i]] = static_cast<int>(palette.size());
+         palette.push_back(ids[i]);
+      }
+   }
+
+   bitsShift = 0;
+   if (palette.size() == 1)
+   {
+      // Sezione uniforme: nessun array di indici
+      std::vector<uint64_t>().swap(data);
+      return;
+   }
+   while ((1u << bitsPerBlock()) < palette.size())
+      bitsShift++;
+
+   // Riempie direttamente parola per parola
+   int bits = bitsPerBlock();
+   int perWord = 64 / bits;
+   data.assign(SECTION_VOLUME / perWord, 0);
+   for (size_t w = 0; w < data.size(); w++)
+   {
+      uint64_t word = 0;
+      const uint8_t *src = ids + w * perWord;
+      for (int k = perWord - 1; k >= 0; k--)
+         word = (word << bits) | static_cast<uint64_t>(remap[src[k]]);
+      data[w] = word;
+   }
+}
+
+size_t ChunkSection::memoryUsage() const
+{
+   return sizeof(ChunkSection) + palette.capacity() + data.capacity() * sizeof(uint64_t);
+}
+
+void ChunkSection::repack(int newBitsShift)
+{
+   std::vector<uint8_t> indices(SECTION_VOLUME);
+   for (int i = 0; i < SECTION_VOLUME; i++)
+      indices[i] = static_cast<uint8_t>(readIndex(i));
+
+   bitsShift = newBitsShift;
+   data.assign(SECTION_VOLUME >> (6 - bitsShift), 0);
+   for (int i = 0; i < SECTION_VOLUME; i++)
+      writeIndex(i, indices[i]);
+}
+
+// ================================
+// CLASSE CHUNK
+// ================================
+void Chunk::set(int localX, int y, int localZ, BlockType type)
+{
+   sections[y / SECTION_HEIGHT].set(localX, y % SECTION_HEIGHT, localZ, type);
+
+   int16_t &columnTop = heightMap[localZ * CHUNK_SIZE + localX];
+   if (type != BlockType::AIR)
+   {
+      if (y > columnTop)
+         columnTop = static_cast<int16_t>(y);
+      maxY = std::max(maxY, y);
+      minY = std::min(minY, y);
+      return;
+   }
+
+   // Rimosso il blocco più alto della colonna: scendi fino al prossimo blocco pieno
+   if (y == columnTop)
+      columnTop = static_cast<int16_t>(findColumnTop(localX, localZ, y - 1));
+
+   if (y == maxY)
+      maxY = *std::max_element(heightMap.begin(), heightMap.end());
+   if (y == minY)
+   {
+      while (minY <= maxY && isLayerEmpty(minY))
+         minY++;
+      if (minY > maxY)
+         minY = CHUNK_HEIGHT;
+   }
+}
+
+int Chunk::findColumnTop(int localX, int localZ, int fromY) const
+{
+   int y = fromY;
+   while (y >= 0)
+   {
+      const ChunkSection &section = sectionAt(y);
+      if (section.isEmpty())
+      {
+         // Salta l'intera sezione d'aria
+         y = (y / SECTION_HEIGHT) * SECTION_HEIGHT - 1;
+         continue;
+      }
+      if (section.get(localX, y % SECTION_HEIGHT, localZ) != BlockType::AIR)
+         return y;
+      y--;
+   }
+   return -1;
+}
+
+void ChunkBorder::setSide(int side, const Chunk &neighbour)
+{
+   sides[side].resize(CHUNK_HEIGHT * CHUNK_SIZE);
+   neighbour.copySideLayer(side ^ 1, sides[side].data());
+}
+
+void Chunk::copySideLayer(int side, uint8_t *ids) const
+{
+   // Lati ±z: strato a z costante, lungo x; lati ±x: strato a x costante, lungo z
+   bool alongX = side < 2;
+   int fixed = (side == 0 || side == 3) ? CHUNK_SIZE - 1 : 0;
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+   {
+      const ChunkSection &section = sections[s];
+      uint8_t *sectionIds = ids + ChunkBorder::sideIndex(s * SECTION_HEIGHT, 0);
+      if (section.isUniform())
+      {
+         std::fill_n(sectionIds, SECTION_HEIGHT * CHUNK_SIZE, static_cast<uint8_t>(section.uniformType()));
+         continue;
+      }
+      for (int y = 0; y < SECTION_HEIGHT; y++)
+         for (int along = 0; along < CHUNK_SIZE; along++)
+            sectionIds[ChunkBorder::sideIndex(y, along)] = static_cast<uint8_t>(
+                alongX ? section.get(along, y, fixed) : section.get(fixed, y, along));
+   }
+}
+
+bool Chunk::isLayerEmpty(int y) const
+{
+   const ChunkSection &section = sectionAt(y);
+   if (section.isUniform())
+      return section.isEmpty();
+   for (int z = 0; z < CHUNK_SIZE; z++)
+      for (int x = 0; x < CHUNK_SIZE; x++)
+         if (section.get(x, y % SECTION_HEIGHT, z) != BlockType::AIR)
+            return false;
+   return true;
+}
+
+void Chunk::recomputeBounds()
+{
+   for (int z = 0; z < CHUNK_SIZE; z++)
+      for (int x = 0; x < CHUNK_SIZE; x++)
+         heightMap[z * CHUNK_SIZE + x] = static_cast<int16_t>(findColumnTop(x, z, CHUNK_HEIGHT - 1));
+   updateVerticalBounds();
+}
+
+void Chunk::updateVerticalBounds()
+{
+   maxY = *std::max_element(heightMap.begin(), heightMap.end());
+   minY = 0;
+   while (minY <= maxY && isLayerEmpty(minY))
+      minY++;
+   if (minY > maxY)
+      minY = CHUNK_HEIGHT;
+}
+
+void Chunk::getBounds(Point3D &boundsMin, Point3D &boundsMax) const
+{
+   float globX = pos.x * CHUNK_SIZE;
+   float globZ = pos.z * CHUNK_SIZE;
+   boundsMin = Point3D(globX - 0.5f, minY - 0.5f, globZ - 0.5f);
+   boundsMax = Point3D(globX + CHUNK_SIZE - 0.5f, maxY + 0.5f, globZ + CHUNK_SIZE - 0.5f);
+}
+
+void Chunk::copyToIds(uint8_t *ids) const
+{
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+      sections[s].unpack(ids + s * SECTION_VOLUME);
+}
+
+void Chunk::fillFromIds(const uint8_t *ids)
+{
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+      sections[s].pack(ids + s * SECTION_VOLUME);
+}
+
+size_t Chunk::blockMemoryUsage() const
+{
+   size_t total = 0;
+   for (const ChunkSection &section : sections)
+      total += section.memoryUsage();
+   return total;
+}
+
+void Chunk::generate(const PerlinNoise &noise)
+{
+   // Parametri esistenti
+   float baseFrequency = 0.01f;
+   int baseHeight = 128;
+   int amplitude = 200;
+   int octaves = 5;
+   float persistence = 0.5f;
+   float biomeFrequency = 0.001f;
+   const int WATER_LEVEL = 110;
+   const int BEACH_RANGE = 2; // Range di altezza per la spiaggia sopra il livello dell'acqua
+
+   // Nuovo parametro per il rumore della sabbia
+   float sandNoiseFrequency = 0.05f; // Frequenza più alta per variazioni più piccole
+
+   // I blocchi vengono scritti in un buffer piatto e compressi nelle sezioni alla fine
+   std::vector<uint8_t> ids(CHUNK_VOLUME, static_cast<uint8_t>(BlockType::AIR));
+   auto put = [&ids](int x, int y, int z, BlockType type)
+   {
+      ids[blockIndex(x, y, z)] = static_cast<uint8_t>(type);
+   };
+
+   // Il rumore di tutte le colonne viene calcolato a blocchi (SIMD), un campo alla volta:
+   // colonna c = x * CHUNK_SIZE + z, stesse coordinate della versione colonna per colonna
+   const int COLUMNS = CHUNK_SIZE * CHUNK_SIZE;
+   std::vector<float> noiseX(COLUMNS), noiseZ(COLUMNS);
+   std::vector<float> biomeNoise(COLUMNS), sandNoiseValues(COLUMNS);
+   std::vector<float> octaveNoise(static_cast<size_t>(octaves) * COLUMNS);
+   auto sampleColumns = [&](float frequency, float *out)
+   {
+      for (int x = 0; x < CHUNK_SIZE; x++)
+      {
+         for (int z = 0; z < CHUNK_SIZE; z++)
+         {
+            int globalX = static_cast<int>(pos.x * CHUNK_SIZE) + x;
+            int globalZ = static_cast<int>(pos.z * CHUNK_SIZE) + z;
+            noiseX[x * CHUNK_SIZE + z] = globalX * frequency;
+            noiseZ[x * CHUNK_SIZE + z] = globalZ * frequency;
+         }
+      }
+      noise.getNoiseBatch(noiseX.data(), 0.0f, noiseZ.data(), out, COLUMNS);
+   };
+
+   sampleColumns(biomeFrequency, biomeNoise.data());
+   sampleColumns(sandNoiseFrequency, sandNoiseValues.data());
+   {
+      float frequency = baseFrequency;
+      for (int i = 0; i < octaves; ++i)
+      {
+         sampleColumns(frequency, octaveNoise.data() + i * COLUMNS);
+         frequency *= 2.0f;
+      }
+   }
+
+   for (int x = 0; x < CHUNK_SIZE; x++)
+   {
+      for (int z = 0; z < CHUNK_SIZE; z++)
+      {
+         const int column = x * CHUNK_SIZE + z;
+
+         float biomeValue = biomeNoise[column];
+         biomeValue = (biomeValue + 1.0f) / 2.0f;
+
+         int localBaseHeight = static_cast<int>(baseHeight * (0.7f + 0.3f * biomeValue));
+         int localAmplitude = static_cast<int>(amplitude * (0.1f + 0.9f * biomeValue));
+
+         float totalNoise = 0.0f;
+         float maxAmplitude = 0.0f;
+         float amplitudeLayer = 1.0f;
+
+         for (int i = 0; i < octaves; ++i)
+         {
+            totalNoise += octaveNoise[i * COLUMNS + column] * amplitudeLayer;
+            maxAmplitude += amplitudeLayer;
+            amplitudeLayer *= persistence;
+         }
+
+         totalNoise /= maxAmplitude;
+         int surfaceHeight = localBaseHeight + static_cast<int>(totalNoise * localAmplitude);
+
+         if (surfaceHeight < 5)
+            surfaceHeight = 5;
+         if (surfaceHeight >= CHUNK_HEIGHT)
+            surfaceHeight = CHUNK_HEIGHT - 1;
+
+         // Sopra il terreno c'è acqua fino al livello del mare: la colonna finisce al più alto dei due
+         heightMap[z * CHUNK_SIZE + x] = static_cast<int16_t>(std::max(surfaceHeight, WATER_LEVEL));
+
+         // Calcola il rumore per la distribuzione della sabbia
+         float sandNoise = sandNoiseValues[column];
+         sandNoise = (sandNoise + 1.0f) / 2.0f; // Normalizza a [0,1]
+
+         for (int y = 0; y < CHUNK_HEIGHT; y++)
+         {
+            if (y > surfaceHeight)
+            {
+               // Se siamo sopra il terreno ma sotto il livello dell'acqua, metti acqua
+               if (y <= WATER_LEVEL)
+               {
+                  put(x, y, z, BlockType::WATER);
+               }
+               else
+               {
+                  put(x, y, z, BlockType::AIR);
+               }
+            }
+            else if (y == surfaceHeight)
+            {
+               // Se siamo al livello della superficie
+               if (y <= WATER_LEVEL + BEACH_RANGE && y >= WATER_LEVEL - BEACH_RANGE)
+               {
+                  // Usa il sandNoise per decidere se mettere sabbia o erba
+                  if (sandNoise > 0.4f) // Regola questa soglia per più o meno sabbia
+                  {
+                     put(x, y, z, BlockType::SAND);
+                  }
+                  else
+                  {
+                     // Se siamo sotto il livello dell'acqua, mettiamo terra invece che erba
+                     if (y < WATER_LEVEL)
+                     {
+                        put(x, y, z, BlockType::DIRT);
+                     }
+                     else
+                     {
+                        put(x, y, z, BlockType::GRASS);
+                     }
+                  }
+               }
+               else if (y < WATER_LEVEL)
+               {
+                  // Sotto il livello dell'acqua, usa sempre sabbia
+                  put(x, y, z, BlockType::SAND);
+               }
+               else
+               {
+                  put(x, y, z, BlockType::GRASS);
+               }
+            }
+            else if (y >= surfaceHeight - 3)
+            {
+               // Anche per gli strati sotto la superficie, usa il noise per decidere
+               if (surfaceHeight <= WATER_LEVEL + BEACH_RANGE && sandNoise > 0.4f)
+               {
+                  put(x, y, z, BlockType::SAND);
+               }
+               else
+               {
+                  put(x, y, z, BlockType::DIRT);
+               }
+            }
+            else if (y < 5)
+            {
+               put(x, y, z, BlockType::BEDROCK);
+            }
+            else
+            {
+               put(x, y, z, BlockType::STONE);
+            }
+         }
+      }
+   }
+
+   fillFromIds(ids.data());
+   updateVerticalBounds();
+}
+
+void Chunk::addQuadTextured(
+    std::vector<uint32_t> &mesh, int face, BlockType type,
+    int x1, int y1, int z1, int s1, int t1,
+    int x2, int y2, int z2, int s2, int t2,
+    int x3, int y3, int z3, int s3, int t3,
+    int x4, int y4, int z4, int s4, int t4)
+{
+   // Faccia e tipo (la cella dell'atlas) sono comuni ai quattro vertici, già pronti per la GPU
+   const uint32_t tile = static_cast<uint32_t>(face) << MESH_FACE_SHIFT |
+                         static_cast<uint32_t>(type) << MESH_TYPE_SHIFT;
+   auto corner = [tile](int x, int y, int z)
+   {
+      return tile | static_cast<uint32_t>(x) << MESH_X_SHIFT | static_cast<uint32_t>(y) << MESH_Y_SHIFT |
+             static_cast<uint32_t>(z) << MESH_Z_SHIFT;
+   };
+   auto repeat = [](int s, int t)
+   {
+      return static_cast<uint32_t>(s) << MESH_S_SHIFT | static_cast<uint32_t>(t) << MESH_T_SHIFT;
+   };
+   const uint32_t quad[4 * MESH_VERTEX_WORDS] = {
+       corner(x1, y1, z1), repeat(s1, t1),
+       corner(x2, y2, z2), repeat(s2, t2),
+       corner(x3, y3, z3), repeat(s3, t3),
+       corner(x4, y4, z4), repeat(s4, t4)};
+   mesh.insert(mesh.end(), quad, quad + 4 * MESH_VERTEX_WORDS);
+}
+
+// Normale (dx, dy, dz) di ciascuna faccia, nell'ordine delle colonne dell'atlas
+static const int FACE_NORMALS[6][3] = {
+    {0, 0, 1},  // Front (+z) : colonna 0
+    {0, 0, -1}, // Back (-z) : colonna 1
+    {-1, 0, 0}, // Left (-x) : colonna 2
+    {1, 0, 0},  // Right (+x) : colonna 3
+    {0, 1, 0},  // Top (+y) : colonna 4
+    {0, -1, 0}  // Bottom (-y) : colonna 5
+};
+
+void Chunk::addFace(std::vector<uint32_t> &mesh, int face, BlockType type, int x0, int y0, int z0, int x1, int y1, int z1)
+{
+   // Spigoli del rettangolo nel chunk (il blocco x occupa gli spigoli x e x + 1)
+   // e dimensioni in blocchi (una texture intera per blocco)
+   int xMin = x0, xMax = x1 + 1;
+   int yMin = y0, yMax = y1 + 1;
+   int zMin = z0, zMax = z1 + 1;
+   int sizeX = x1 - x0 + 1;
+   int sizeY = y1 - y0 + 1;
+   int sizeZ = z1 - z0 + 1;
+
+   switch (face)
+   {
+   case 0: // Front (+z)
+      addQuadTextured(mesh, face, type,
+                      xMin, yMin, zMax, 0, sizeY,
+                      xMax, yMin, zMax, sizeX, sizeY,
+                      xMax, yMax, zMax, sizeX, 0,
+                      xMin, yMax, zMax, 0, 0);
+      break;
+   case 1: // Back (-z)
+      addQuadTextured(mesh, face, type,
+                      xMax, yMin, zMin, 0, sizeY,
+                      xMin, yMin, zMin, sizeX, sizeY,
+                      xMin, yMax, zMin, sizeX, 0,
+                      xMax, yMax, zMin, 0, 0);
+      break;
+   case 2: // Left (-x)
+      addQuadTextured(mesh, face, type,
+                      xMin, yMin, zMin, 0, sizeY,
+                      xMin, yMin, zMax, sizeZ, sizeY,
+                      xMin, yMax, zMax, sizeZ, 0,
+                      xMin, yMax, zMin, 0, 0);
+      break;
+   case 3: // Right (+x)
+      addQuadTextured(mesh, face, type,
+                      xMax, yMin, zMax, 0, sizeY,
+                      xMax, yMin, zMin, sizeZ, sizeY,
+                      xMax, yMax, zMin, sizeZ, 0,
+                      xMax, yMax, zMax, 0, 0);
+      break;
+   case 4: // Top (+y)
+      addQuadTextured(mesh, face, type,
+                      xMin, yMax, zMax, 0, 0,
+                      xMax, yMax, zMax, sizeX, 0,
+                      xMax, yMax, zMin, sizeX, sizeZ,
+                      xMin, yMax, zMin, 0, sizeZ);
+      break;
+   case 5: // Bottom (-y)
+      addQuadTextured(mesh, face, type,
+                      xMin, yMin, zMin, 0, 0,
+                      xMax, yMin, zMin, sizeX, 0,
+                      xMax, yMin, zMax, sizeX, sizeZ,
+                      xMin, yMin, zMax, 0, sizeZ);
+      break;
+   }
+}
+
+void Chunk::generateMesh(MeshingMode mode, const ChunkBorder *border, uint32_t sectionMask)
+{
+   // Decodifica una sola volta le sezioni da rigenerare e quelle confinanti in verticale,
+   // che servono per le facce sul bordo della sezione: il mesher legge poi da un array piatto
+   std::vector<uint8_t> ids(CHUNK_VOLUME);
+   uint32_t decoded = 0;
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+   {
+      if (!(sectionMask & (1u << s)))
+         continue;
+      for (int n = std::max(s - 1, 0); n <= std::min(s + 1, SECTIONS_PER_CHUNK - 1); n++)
+      {
+         if (!(decoded & (1u << n)))
+            sections[n].unpack(&ids[static_cast<size_t>(n) * SECTION_VOLUME]);
+         decoded |= 1u << n;
+      }
+   }
+
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+   {
+      if (!(sectionMask & (1u << s)))
+         continue;
+      meshSections[s].data.clear();
+      if (mode == MeshingMode::GREEDY)
+         generateGreedyMesh(ids.data(), border, s);
+      else
+         generatePerFaceMesh(ids.data(), border, s);
+      meshSections[s].dirty = true;
+   }
+
+   updateMeshBorderSides(border ? border->sideMask() : 0, sectionMask);
+
+   // Il caricamento sulla GPU avviene a parte, nel thread di rendering
+   meshDirty = true;
+}
+
+void Chunk::generatePerFaceMesh(const uint8_t *ids, const ChunkBorder *border, int s)
+{
+   const ChunkSection &section = sections[s];
+   // Sezione tutta d'aria: nessuna faccia da generare
+   if (section.isEmpty())
+      return;
+   std::vector<uint32_t> &mesh = meshSections[s].data;
+
+   auto blockAt = [ids](int x, int y, int z) -> BlockType
+   {
+      return static_cast<BlockType>(ids[blockIndex(x, y, z)]);
+   };
+
+   // face è anche il lato del chunk quando il vicino cade fuori in orizzontale
+   auto faceVisible = [&blockAt, border](int face, int x, int z, int y, int dx, int dz, int dy) -> bool
+   {
+      int nx = x + dx, nz = z + dz, ny = y + dy;
+      if (ny < 0 || ny >= CHUNK_HEIGHT)
+         return true;
+      if (nx < 0 || nx >= CHUNK_SIZE || nz < 0 || nz >= CHUNK_SIZE)
+      {
+         if (!border || !border->hasSide(face))
+            return true;
+         int along = dz != 0 ? x : z;
+         return border->sides[face][ChunkBorder::sideIndex(y, along)] == static_cast<uint8_t>(BlockType::AIR);
+      }
+      return blockAt(nx, ny, nz) == BlockType::AIR;
+   };
+
+   // Scorre i blocchi della sezione nello stesso ordine in cui sono memorizzati (y, z, x),
+   // limitandosi alle quote comprese tra minY e maxY.
+   // In una sezione uniforme piena solo i blocchi sul guscio esterno possono avere facce visibili.
+   bool shellOnly = section.isUniform();
+   int yBegin = s * SECTION_HEIGHT;
+   int yEnd = yBegin + SECTION_HEIGHT;
+
+   for (int y = std::max(yBegin, minY); y < std::min(yEnd, maxY + 1); y++)
+   {
+      bool shellLayer = !shellOnly || y == yBegin || y == yEnd - 1;
+      for (int z = 0; z < CHUNK_SIZE; z++)
+      {
+         int xStep = (!shellLayer && z > 0 && z < CHUNK_SIZE - 1) ? CHUNK_SIZE - 1 : 1;
+         for (int x = 0; x < CHUNK_SIZE; x += xStep)
+         {
+            BlockType type = blockAt(x, y, z);
+            if (type == BlockType::AIR)
+               continue;
+
+            for (int face = 0; face < 6; face++)
+            {
+               const int *normal = FACE_NORMALS[face];
+               if (faceVisible(face, x, z, y, normal[0], normal[2], normal[1]))
+                  addFace(mesh, face, type, x, y, z, x, y, z);
+            }
+         }
+      }
+   }
+}
+
+void Chunk::generateGreedyMesh(const uint8_t *ids, const ChunkBorder *border, int s)
+{
+   const uint8_t NO_FACE = static_cast<uint8_t>(BlockType::AIR);
+   // Le facce non escono dalla sezione: i rettangoli si fermano ai suoi bordi verticali
+   const int yBegin = std::max(minY, s * SECTION_HEIGHT);
+   const int yEnd = std::min(maxY + 1, (s + 1) * SECTION_HEIGHT);
+   if (yEnd <= yBegin || sections[s].isEmpty())
+      return;
+   std::vector<uint32_t> &mesh = meshSections[s].data;
+
+   // Sezione uniforme piena: al suo interno nessuna faccia è visibile
+   const bool solidSection = sections[s].isUniform();
+
+   // Maschera di uno strato: tipo della faccia visibile in ogni cella, NO_FACE se non c'è
+   std::array<uint8_t, CHUNK_SIZE * SECTION_HEIGHT> mask;
+
+   for (int face = 0; face < 6; face++)
+   {
+      const int *normal = FACE_NORMALS[face];
+      // Asse della normale (0 x, 1 y, 2 z) e assi del piano: le colonne sono orizzontali,
+      // le righe sono lungo y per le facce laterali e lungo z per quelle orizzontali
+      const int normalAxis = normal[0] != 0 ? 0 : (normal[1] != 0 ? 1 : 2);
+      const int columnAxis = normalAxis == 0 ? 2 : 0;
+      const int rowAxis = normalAxis == 1 ? 2 : 1;
+      const int begin[3] = {0, yBegin, 0};
+      const int end[3] = {CHUNK_SIZE, yEnd, CHUNK_SIZE};
+      const int columns = end[columnAxis] - begin[columnAxis];
+      const int rows = end[rowAxis] - begin[rowAxis];
+
+      for (int slice = begin[normalAxis]; slice < end[normalAxis]; slice++)
+      {
+         // Il vicino nella direzione della faccia è dentro il chunk?
+         int neighbourSlice = slice + normal[normalAxis];
+         int sliceLimit = normalAxis == 1 ? CHUNK_HEIGHT : CHUNK_SIZE;
+         bool neighbourInside = neighbourSlice >= 0 && neighbourSlice < sliceLimit;
+         // Strato del chunk confinante, se lo strato è sul bordo laterale e il vicino è noto
+         const uint8_t *outside = nullptr;
+         if (!neighbourInside && normalAxis != 1 && border && border->hasSide(face))
+            outside = border->sides[face].data();
+
+         // Strato orizzontale interno a una sezione uniforme piena: nessuna faccia
+         if (normalAxis == 1 && solidSection && neighbourInside && neighbourSlice / SECTION_HEIGHT == s)
+            continue;
+
+         bool anyFace = false;
+         for (int r = 0; r < rows; r++)
+         {
+            uint8_t *maskRow = &mask[static_cast<size_t>(r) * columns];
+            int p[3];
+            p[normalAxis] = slice;
+            p[rowAxis] = begin[rowAxis] + r;
+
+            // Riga (a y costante) interna a una sezione uniforme piena: nessuna faccia
+            if (normalAxis != 1 && solidSection && neighbourInside)
+            {
+               std::fill(maskRow, maskRow + columns, NO_FACE);
+               continue;
+            }
+
+            for (int c = 0; c < columns; c++)
+            {
+               p[columnAxis] = begin[columnAxis] + c;
+               uint8_t type = ids[blockIndex(p[0], p[1], p[2])];
+               if (type != NO_FACE && neighbourInside &&
+                   ids[blockIndex(p[0] + normal[0], p[1] + normal[1], p[2] + normal[2])] != NO_FACE)
+                  type = NO_FACE;
+               else if (type != NO_FACE && outside &&
+                        outside[ChunkBorder::sideIndex(p[1], p[columnAxis])] != NO_FACE)
+                  type = NO_FACE;
+               maskRow[c] = type;
+               anyFace |= type != NO_FACE;
+            }
+         }
+         if (!anyFace)
+            continue;
+
+         // Unisce le celle uguali: prima in larghezza lungo la riga, poi in altezza per righe intere
+         for (int r = 0; r < rows; r++)
+         {
+            for (int c = 0; c < columns;)
+            {
+               uint8_t type = mask[static_cast<size_t>(r) * columns + c];
+               if (type == NO_FACE)
+               {
+                  c++;
+                  continue;
+               }
+
+               int width = 1;
+               while (c + width < columns && mask[static_cast<size_t>(r) * columns + c + width] == type)
+                  width++;
+
+               int height = 1;
+               while (r + height < rows)
+               {
+                  const uint8_t *next = &mask[static_cast<size_t>(r + height) * columns + c];
+                  if (std::any_of(next, next + width, [type](uint8_t cell)
+                                  { return cell != type; }))
+                     break;
+                  height++;
+               }
+
+               for (int dr = 0; dr < height; dr++)
+               {
+                  uint8_t *covered = &mask[static_cast<size_t>(r + dr) * columns + c];
+                  std::fill(covered, covered + width, NO_FACE);
+               }
+
+               int first[3], last[3];
+               first[normalAxis] = last[normalAxis] = slice;
+               first[columnAxis] = begin[columnAxis] + c;
+               last[columnAxis] = begin[columnAxis] + c + width - 1;
+               first[rowAxis] = begin[rowAxis] + r;
+               last[rowAxis] = begin[rowAxis] + r + height - 1;
+               addFace(mesh, face, static_cast<BlockType>(type), first[0], first[1], first[2], last[0], last[1], last[2]);
+
+               c += width;
+            }
+         }
+      }
+   }
+}
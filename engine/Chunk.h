@@ -0,0 +1,356 @@
+// ================================
+// CHUNK E SEZIONI
+// ================================
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Core.h"
+#include "PerlinNoise.h"
+
+// Variabili globali per il sistema delle texture (dimensioni dell'atlas, impostate al caricamento)
+extern int atlasWidth;
+extern int atlasHeight;
+const int textureCellSize = 16;
+
+// Vertice della mesh impacchettato in due parole a 32 bit (8 byte), decodificato dallo shader dei chunk.
+// Parola 0: spigolo del blocco nel chunk (x e z su 5 bit, 0..16; y su 9 bit, 0..256), faccia
+// (3 bit, colonna della cella nell'atlas) e tipo del blocco (8 bit, riga della cella).
+// Parola 1: coordinate di ripetizione (s,t) della texture misurate in blocchi (9 bit ciascuna).
+// La posizione nel mondo è origine del chunk (uniform dello shader) + spigolo - 0.5. Il renderer
+// ripete la texture dentro la cella con fract(s,t), così anche una faccia che copre più blocchi resta corretta.
+const int MESH_VERTEX_WORDS = 2;
+const int MESH_VERTEX_BYTES = MESH_VERTEX_WORDS * sizeof(uint32_t);
+// Primo bit di ciascun campo nella sua parola
+const int MESH_X_SHIFT = 0;
+const int MESH_Z_SHIFT = 5;
+const int MESH_Y_SHIFT = 10;
+const int MESH_FACE_SHIFT = 19;
+const int MESH_TYPE_SHIFT = 22;
+const int MESH_S_SHIFT = 0;
+const int MESH_T_SHIFT = 9;
+const uint32_t MESH_REPEAT_MASK = 0x1FF; // 9 bit di s e di t
+// Ogni quadrilatero ha quattro vertici propri ed è disegnato come due triangoli indicizzati con gli
+// spigoli MESH_QUAD_CORNERS. Gli indici di un quadrilatero sono quindi sempre 4 * quad + spigolo:
+// il renderer li prende da un unico index buffer precalcolato, condiviso da tutti i chunk.
+const int MESH_QUAD_VERTICES = 4;
+const int MESH_QUAD_INDICES = 6;
+const uint32_t MESH_QUAD_CORNERS[MESH_QUAD_INDICES] = {0, 1, 2, 0, 2, 3};
+
+// Modalità di generazione della mesh
+enum class MeshingMode
+{
+   PER_FACE, // Un quadrilatero per ogni faccia visibile
+   GREEDY    // Facce visibili complanari dello stesso tipo unite in rettangoli
+};
+
+// Classe Sezione: porzione 16x16x16 di un chunk.
+// Ogni sezione ha una palette locale dei tipi presenti e un array di indici nella palette
+// impacchettati a 1, 2, 4 o 8 bit per blocco; la larghezza cresce quando viene aggiunto un nuovo tipo.
+// Una sezione con un solo tipo di blocco è "uniforme": non ha array di indici e costa solo la palette.
+class ChunkSection
+{
+public:
+   std::vector<uint8_t> palette; // ID dei tipi di blocco presenti nella sezione
+   std::vector<uint64_t> data;   // Indici nella palette, impacchettati in parole da 64 bit (vuoto se uniforme)
+   int bitsShift = 0;            // log2 dei bit per blocco (0 -> 1 bit, 3 -> 8 bit)
+
+   ChunkSection(BlockType fill = BlockType::AIR)
+       : palette(1, static_cast<uint8_t>(fill)), bitsShift(0) {}
+
+   // Vero se tutta la sezione contiene un solo tipo di blocco
+   inline bool isUniform() const { return data.empty(); }
+
+   // Tipo di blocco di una sezione uniforme
+   inline BlockType uniformType() const { return static_cast<BlockType>(palette[0]); }
+
+   // Vero se la sezione è interamente d'aria
+   inline bool isEmpty() const { return isUniform() && uniformType() == BlockType::AIR; }
+
+   // Indice del blocco all'interno della sezione (y locale alla sezione)
+   static inline int blockIndex(int localX, int sectionY, int localZ)
+   {
+      return (sectionY * CHUNK_SIZE + localZ) * CHUNK_SIZE + localX;
+   }
+
+   inline int bitsPerBlock() const { return 1 << bitsShift; }
+
+   // Legge l'indice di palette del blocco i-esimo
+   inline int readIndex(int i) const
+   {
+      int perWordShift = 6 - bitsShift;
+      int bitPos = (i & ((1 << perWordShift) - 1)) << bitsShift;
+      return static_cast<int>((data[i >> perWordShift] >> bitPos) & ((1u << bitsPerBlock()) - 1));
+   }
+
+   // Scrive l'indice di palette del blocco i-esimo
+   inline void writeIndex(int i, int paletteIndex)
+   {
+      int perWordShift = 6 - bitsShift;
+      int bitPos = (i & ((1 << perWordShift) - 1)) << bitsShift;
+      uint64_t mask = static_cast<uint64_t>((1u << bitsPerBlock()) - 1) << bitPos;
+      uint64_t &word = data[i >> perWordShift];
+      word = (word & ~mask) | (static_cast<uint64_t>(paletteIndex) << bitPos);
+   }
+
+   inline BlockType get(int localX, int sectionY, int localZ) const
+   {
+      if (isUniform())
+         return uniformType();
+      return static_cast<BlockType>(palette[readIndex(blockIndex(localX, sectionY, localZ))]);
+   }
+
+   void set(int localX, int sectionY, int localZ, BlockType type);
+
+   // Percorso di lettura veloce: decodifica l'intera sezione in ID a un byte (ordine y, z, x)
+   void unpack(uint8_t *out) const;
+
+   // Ricostruisce palette e indici da SECTION_VOLUME ID a un byte (ordine y, z, x)
+   void pack(const uint8_t *ids);
+
+   // Memoria occupata dalla sezione (struttura più dati allocati)
+   size_t memoryUsage() const;
+
+private:
+   // Cambia la larghezza degli indici mantenendo i valori
+   void repack(int newBitsShift);
+};
+
+// Lati orizzontali di un chunk, nello stesso ordine delle prime quattro facce della mesh:
+// 0 +z, 1 -z, 2 -x, 3 +x. Il lato opposto a side è side ^ 1.
+const int CHUNK_SIDES = 4;
+
+class Chunk;
+
+// Strati di blocchi dei chunk confinanti che toccano i quattro lati di un chunk.
+// Il mesher li usa per nascondere le facce sul bordo coperte dal vicino; un lato senza dati
+// (vicino non caricato) lascia visibili le facce di quel bordo.
+struct ChunkBorder
+{
+   // Per ogni lato CHUNK_HEIGHT * CHUNK_SIZE ID, indice sideIndex(y, posizione lungo il lato);
+   // la posizione lungo il lato è x per i lati ±z e z per i lati ±x. Vuoto se il vicino manca.
+   std::array<std::vector<uint8_t>, CHUNK_SIDES> sides;
+
+   static inline int sideIndex(int y, int along)
+   {
+      return y * CHUNK_SIZE + along;
+   }
+
+   inline bool hasSide(int side) const { return !sides[side].empty(); }
+
+   // Lati con i dati del vicino (bit 1 << lato)
+   inline uint8_t sideMask() const
+   {
+      uint8_t mask = 0;
+      for (int side = 0; side < CHUNK_SIDES; side++)
+         if (hasSide(side))
+            mask |= 1 << side;
+      return mask;
+   }
+
+   // Copia lo strato del vicino che tocca il lato side (il suo lato opposto)
+   void setSide(int side, const Chunk &neighbour);
+};
+
+// Mesh di una sezione del chunk: le facce visibili dei suoi blocchi. Le sezioni hanno mesh separate,
+// così una modifica rigenera e ricarica solo le sezioni che tocca.
+struct SectionMesh
+{
+   // Vertici impacchettati generati sulla CPU (MESH_VERTEX_WORDS parole, MESH_QUAD_VERTICES per quadrilatero)
+   std::vector<uint32_t> data;
+   // Vero se data è stata rigenerata e non è ancora stata caricata sulla GPU
+   bool dirty = false;
+   // Versione della richiesta di meshing da cui proviene data: le mesh generate in parallelo
+   // possono arrivare fuori ordine e una più vecchia non deve sostituire una più recente
+   uint64_t version = 0;
+   // Versione dell'ultima richiesta di meshing della sezione, assegnata al momento della richiesta:
+   // vengono accettate solo le mesh di quella richiesta o di una successiva. Un chunk ricaricato
+   // riparte da zero, ma le richieste fatte per la sua copia scaricata possono essere ancora in corso.
+   uint64_t requestedVersion = 0;
+   // Intervallo riservato alla sezione nel vertex buffer del chunk, in vertici (gestito dal renderer)
+   size_t gpuFirstVertex = 0;
+   size_t gpuCapacity = 0;
+   // Quadrilateri caricati sulla GPU (0: sezione saltata nel disegno)
+   size_t gpuQuadCount = 0;
+
+   inline size_t vertexCount() const { return data.size() / MESH_VERTEX_WORDS; }
+};
+
+// Classe Chunk
+class Chunk
+{
+public:
+   Point2D pos; // Coordinate del chunk (in termini di chunk, non di blocco)
+   // Sedici sezioni 16x16x16 impilate lungo y, ciascuna compressa con una palette locale.
+   // Le posizioni dei blocchi non sono memorizzate: si ricavano da pos e dagli indici locali.
+   std::vector<ChunkSection> sections;
+   // Heightmap: quota del blocco non d'aria più alto di ogni colonna (-1 se vuota), indice z * CHUNK_SIZE + x
+   std::array<int16_t, CHUNK_SIZE * CHUNK_SIZE> heightMap;
+   // Limiti verticali dei blocchi non d'aria del chunk (minY > maxY se il chunk è vuoto)
+   int minY = CHUNK_HEIGHT;
+   int maxY = -1;
+   // Maschera di tutte le sezioni (bit 1 << indice della sezione)
+   static const uint32_t ALL_SECTIONS = (1u << SECTIONS_PER_CHUNK) - 1;
+
+   // Mesh delle sezioni, dal basso verso l'alto
+   std::array<SectionMesh, SECTIONS_PER_CHUNK> meshSections;
+   // Vero se almeno una sezione ha una mesh non ancora caricata sulla GPU
+   bool meshDirty = false;
+   // Lati di cui l'ultima mesh conosceva il vicino (bit 1 << lato): gli altri vanno rigenerati quando il vicino arriva
+   uint8_t meshBorderSides = 0;
+
+   // Buffer OpenGL (gestiti dal renderer, il motore non chiama mai OpenGL).
+   // Appartengono al chunk in chunksMap: vengono restituiti al renderer tramite World::onChunkUnload.
+   unsigned int vao = 0;
+   unsigned int vbo = 0;   // Contiene le mesh di tutte le sezioni, ciascuna nel suo intervallo
+   size_t vboCapacity = 0; // Byte allocati nel vbo (la sua classe di dimensione nel pool)
+
+   // Costruttore di default
+   Chunk() : pos(0, 0), sections(SECTIONS_PER_CHUNK)
+   {
+      heightMap.fill(-1);
+   }
+
+   // Costruttore che riceve le coordinate del chunk
+   Chunk(Point2D p) : pos(p), sections(SECTIONS_PER_CHUNK)
+   {
+      heightMap.fill(-1);
+   }
+
+   // Indice in un array piatto di CHUNK_VOLUME ID (ordine y, z, x) a partire dalle coordinate locali
+   static inline int blockIndex(int localX, int y, int localZ)
+   {
+      return (y * CHUNK_SIZE + localZ) * CHUNK_SIZE + localX;
+   }
+
+   // Legge il tipo del blocco alle coordinate locali (nessun controllo dei limiti)
+   inline BlockType get(int localX, int y, int localZ) const
+   {
+      return sections[y / SECTION_HEIGHT].get(localX, y % SECTION_HEIGHT, localZ);
+   }
+
+   // Sezione che contiene la quota y locale
+   inline const ChunkSection &sectionAt(int y) const
+   {
+      return sections[y / SECTION_HEIGHT];
+   }
+
+   // Imposta il tipo del blocco alle coordinate locali (nessun controllo dei limiti).
+   // Heightmap e limiti verticali vengono aggiornati in modo incrementale.
+   void set(int localX, int y, int localZ, BlockType type);
+
+   // Quota del blocco non d'aria più alto della colonna partendo da fromY (-1 se non ce ne sono)
+   int findColumnTop(int localX, int localZ, int fromY) const;
+
+   // Vero se lo strato orizzontale alla quota y è tutto d'aria
+   bool isLayerEmpty(int y) const;
+
+   // Quota del blocco non d'aria più alto della colonna locale, in O(1)
+   inline int columnHeight(int localX, int localZ) const
+   {
+      return heightMap[localZ * CHUNK_SIZE + localX];
+   }
+
+   // Ricalcola heightmap e limiti verticali dai blocchi (dopo un caricamento)
+   void recomputeBounds();
+
+   // Ricava minY e maxY dalla heightmap già aggiornata
+   void updateVerticalBounds();
+
+   // Bounding box del chunk nel mondo, limitata in verticale ai blocchi occupati
+   void getBounds(Point3D &boundsMin, Point3D &boundsMax) const;
+
+   // Decodifica tutti i blocchi in un array piatto di CHUNK_VOLUME ID (ordine y, z, x)
+   void copyToIds(uint8_t *ids) const;
+
+   // Copia lo strato di blocchi sul lato side del chunk in CHUNK_HEIGHT * CHUNK_SIZE ID
+   // (indice ChunkBorder::sideIndex)
+   void copySideLayer(int side, uint8_t *ids) const;
+
+   // Sostituisce tutti i blocchi con quelli di un array piatto di CHUNK_VOLUME ID (ordine y, z, x)
+   void fillFromIds(const uint8_t *ids);
+
+   // Memoria occupata dai blocchi del chunk
+   size_t blockMemoryUsage() const;
+
+   // Posizione nel mondo del blocco alle coordinate locali, calcolata al volo
+   inline Point3D blockWorldPos(int localX, int y, int localZ) const
+   {
+      return Point3D(pos.x * CHUNK_SIZE + localX, y, pos.z * CHUNK_SIZE + localZ);
+   }
+
+   // Versione del generatore del terreno: va incrementata a ogni modifica di generate() o del
+   // rumore che cambia i blocchi prodotti a parità di seed. I chunk salvati come differenze la
+   // registrano e non vengono applicati a un terreno generato da una versione diversa.
+   static const uint32_t GENERATOR_VERSION = 1;
+
+   // Funzione per generare il terreno del chunk
+   void generate(const PerlinNoise &noise);
+
+   // Genera la mesh (solo CPU) delle sezioni in sectionMask escludendo le facce adiacenti.
+   // Con border vengono escluse anche le facce sul bordo coperte dai chunk confinanti.
+   void generateMesh(MeshingMode mode = MeshingMode::GREEDY, const ChunkBorder *border = nullptr,
+                     uint32_t sectionMask = ALL_SECTIONS);
+
+   // Registra in meshBorderSides i lati noti (borderSides) alla mesh delle sezioni in sectionMask.
+   // Dopo una rigenerazione parziale le altre sezioni conoscono ancora solo i lati di prima.
+   inline void updateMeshBorderSides(uint8_t borderSides, uint32_t sectionMask)
+   {
+      meshBorderSides = sectionMask == ALL_SECTIONS ? borderSides : meshBorderSides & borderSides;
+   }
+
+   // Sezioni la cui mesh cambia quando cambia un blocco alla quota y: la sua e, se il blocco
+   // è sul bordo della sezione, quella confinante in verticale
+   static inline uint32_t sectionsTouchedBy(int y)
+   {
+      int section = y / SECTION_HEIGHT;
+      uint32_t mask = 1u << section;
+      if (y % SECTION_HEIGHT == 0 && section > 0)
+         mask |= 1u << (section - 1);
+      if (y % SECTION_HEIGHT == SECTION_HEIGHT - 1 && section < SECTIONS_PER_CHUNK - 1)
+         mask |= 1u << (section + 1);
+      return mask;
+   }
+
+   // Numero di vertici della mesh generata sulla CPU (tutte le sezioni)
+   inline size_t meshVertexCount() const
+   {
+      size_t vertices = 0;
+      for (const SectionMesh &mesh : meshSections)
+         vertices += mesh.vertexCount();
+      return vertices;
+   }
+
+   // Numero di quadrilateri (coppie di triangoli) della mesh generata sulla CPU
+   inline size_t meshQuadCount() const
+   {
+      return meshVertexCount() / MESH_QUAD_VERTICES;
+   }
+
+private:
+   // I mesher generano la mesh della sezione section leggendo gli ID decodificati
+   // della sezione e di quelle confinanti in verticale (array piatto, ordine y, z, x)
+
+   // Mesher classico: un quadrilatero per ogni faccia visibile
+   void generatePerFaceMesh(const uint8_t *ids, const ChunkBorder *border, int section);
+
+   // Mesher greedy: per ogni direzione e ogni strato unisce le facce visibili dello stesso tipo
+   // in rettangoli, scorrendo prima lungo le colonne e poi estendendo per righe intere
+   void generateGreedyMesh(const uint8_t *ids, const ChunkBorder *border, int section);
+
+   // Aggiunge a mesh la faccia face (colonna dell'atlas: 0 +z, 1 -z, 2 -x, 3 +x, 4 +y, 5 -y) del rettangolo
+   // di blocchi compreso tra (x0,y0,z0) e (x1,y1,z1), estremi inclusi, con la texture del tipo type
+   static void addFace(std::vector<uint32_t> &mesh, int face, BlockType type, int x0, int y0, int z0, int x1, int y1, int z1);
+
+   // Funzione helper per aggiungere un quadrilatero (quattro vertici) alla mesh: per ogni vertice
+   // lo spigolo (x,y,z) nel chunk e le coordinate di ripetizione (s,t); faccia e tipo sono comuni
+   static void addQuadTextured(
+       std::vector<uint32_t> &mesh, int face, BlockType type,
+       int x1, int y1, int z1, int s1, int t1,
+       int x2, int y2, int z2, int s2, int t2,
+       int x3, int y3, int z3, int s3, int t3,
+       int x4, int y4, int z4, int s4, int t4);
+};
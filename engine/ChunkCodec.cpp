@@ -0,0 +1,447 @@
+// ================================
+// CODIFICA DEI CHUNK SU DISCO
+// ================================
+#include "ChunkCodec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+   const char MAGIC[3] = {'M', 'G', 'C'};
+
+   // Parametri del passaggio LZ
+   const int LZ_MIN_MATCH = 4;
+   const int LZ_HASH_BITS = 12;
+   const size_t LZ_MAX_OFFSET = 65535;
+
+   inline uint32_t read32(const uint8_t *p)
+   {
+      uint32_t value;
+      std::memcpy(&value, p, sizeof(value));
+      return value;
+   }
+
+   inline uint32_t lzHash(uint32_t sequence)
+   {
+      return (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+   }
+
+   void writeVarint(std::vector<uint8_t> &out, uint32_t value)
+   {
+      while (value >= 0x80)
+      {
+         out.push_back(static_cast<uint8_t>(value | 0x80));
+         value >>= 7;
+      }
+      out.push_back(static_cast<uint8_t>(value));
+   }
+
+   bool readVarint(const uint8_t *&p, const uint8_t *end, uint32_t &value)
+   {
+      value = 0;
+      for (int shift = 0; shift < 32 && p < end; shift += 7)
+      {
+         uint8_t byte = *p++;
+         value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+         if (!(byte & 0x80))
+            return true;
+      }
+      return false;
+   }
+
+   // Lunghezza oltre i 15 del token: byte da 255 seguiti dal resto
+   void writeLzLength(std::vector<uint8_t> &out, size_t length)
+   {
+      for (; length >= 255; length -= 255)
+         out.push_back(255);
+      out.push_back(static_cast<uint8_t>(length));
+   }
+
+   bool readLzLength(const uint8_t *&p, const uint8_t *end, size_t &length)
+   {
+      uint8_t byte;
+      do
+      {
+         if (p >= end)
+            return false;
+         byte = *p++;
+         length += byte;
+      } while (byte == 255);
+      return true;
+   }
+
+   // Sequenza LZ: letterali [literal, literal + literalCount) seguiti (se matchLength > 0) da una copia
+   void writeLzSequence(std::vector<uint8_t> &out, const uint8_t *literal, size_t literalCount,
+                        size_t offset, size_t matchLength)
+   {
+      size_t matchCode = matchLength > 0 ? matchLength - LZ_MIN_MATCH : 0;
+      out.push_back(static_cast<uint8_t>((std::min<size_t>(literalCount, 15) << 4) | std::min<size_t>(matchCode, 15)));
+      if (literalCount >= 15)
+         writeLzLength(out, literalCount - 15);
+      out.insert(out.end(), literal, literal + literalCount);
+      if (matchLength == 0)
+         return;
+      out.push_back(static_cast<uint8_t>(offset & 0xFF));
+      out.push_back(static_cast<uint8_t>(offset >> 8));
+      if (matchCode >= 15)
+         writeLzLength(out, matchCode - 15);
+   }
+}
+
+void ChunkCodec::encode(const Chunk &chunk, std::vector<char> &out, bool compress)
+{
+   std::vector<uint8_t> ids(CHUNK_VOLUME);
+   chunk.copyToIds(ids.data());
+
+   // Palette del chunk nell'ordine di comparsa
+   int remap[256];
+   std::fill(std::begin(remap), std::end(remap), -1);
+   std::vector<uint8_t> palette;
+   for (uint8_t id : ids)
+   {
+      if (remap[id] < 0)
+      {
+         remap[id] = static_cast<int>(palette.size());
+         palette.push_back(id);
+      }
+   }
+
+   std::vector<uint8_t> body;
+   body.reserve(4096);
+   body.push_back(static_cast<uint8_t>(palette.size() - 1));
+   body.insert(body.end(), palette.begin(), palette.end());
+
+   // Run per colonne; una run può continuare nella colonna successiva
+   int runIndex = -1;
+   uint32_t runLength = 0;
+   for (int x = 0; x < CHUNK_SIZE; x++)
+      for (int z = 0; z < CHUNK_SIZE; z++)
+         for (int y = 0; y < CHUNK_HEIGHT; y++)
+         {
+            int index = remap[ids[Chunk::blockIndex(x, y, z)]];
+            if (index == runIndex)
+            {
+               runLength++;
+               continue;
+            }
+            if (runLength > 0)
+            {
+               body.push_back(static_cast<uint8_t>(runIndex));
+               writeVarint(body, runLength);
+            }
+            runIndex = index;
+            runLength = 1;
+         }
+   body.push_back(static_cast<uint8_t>(runIndex));
+   writeVarint(body, runLength);
+
+   writeEncoded(body, 0, compress, out);
+}
+
+void ChunkCodec::encodeDelta(const Chunk &chunk, const Chunk &baseline, const DeltaBaseline &origin,
+                             std::vector<char> &out, bool compress)
+{
+   std::vector<uint8_t> ids(CHUNK_VOLUME), baseIds(CHUNK_VOLUME);
+   chunk.copyToIds(ids.data());
+   baseline.copyToIds(baseIds.data());
+
+   // Blocchi diversi dal chunk rigenerato, nello stesso ordine per colonne del formato completo:
+   // distanza dal precedente (varint) e nuovo ID
+   std::vector<uint8_t> changes;
+   uint32_t count = 0;
+   uint32_t next = 0;
+   uint32_t position = 0;
+   for (int x = 0; x < CHUNK_SIZE; x++)
+      for (int z = 0; z < CHUNK_SIZE; z++)
+         for (int y = 0; y < CHUNK_HEIGHT; y++, position++)
+         {
+            int index = Chunk::blockIndex(x, y, z);
+            if (ids[index] == baseIds[index])
+               continue;
+            writeVarint(changes, position - next);
+            changes.push_back(ids[index]);
+            next = position + 1;
+            count++;
+         }
+
+   std::vector<uint8_t> body(sizeof(origin.seed));
+   std::memcpy(body.data(), &origin.seed, sizeof(origin.seed));
+   writeVarint(body, origin.generator);
+   writeVarint(body, count);
+   body.insert(body.end(), changes.begin(), changes.end());
+   writeEncoded(body, FLAG_DELTA, compress, out);
+}
+
+bool ChunkCodec::isEncoded(const char *data, size_t size)
+{
+   return size >= HEADER_BYTES && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+bool ChunkCodec::isDelta(const char *data, size_t size)
+{
+   return isEncoded(data, size) && (static_cast<uint8_t>(data[4]) & FLAG_DELTA);
+}
+
+bool ChunkCodec::decode(const char *data, size_t size, Chunk &chunk)
+{
+   std::vector<uint8_t> storage;
+   const uint8_t *p;
+   const uint8_t *end;
+   uint8_t flags;
+   if (!readBody(data, size, storage, p, end, flags) || (flags & FLAG_DELTA) || p >= end)
+      return false;
+   size_t paletteSize = static_cast<size_t>(*p++) + 1;
+   if (static_cast<size_t>(end - p) < paletteSize)
+      return false;
+   const uint8_t *palette = p;
+   p += paletteSize;
+
+   // Le run riempiono un buffer per colonne (stesso ordine del formato, quindi una run è un fill
+   // contiguo). Intanto si ricavano la heightmap (quota dell'ultima run non d'aria di ogni colonna)
+   // e le sezioni attraversate da un solo tipo, che diventano uniformi senza passare dagli ID.
+   std::vector<uint8_t> columns(CHUNK_VOLUME);
+   std::array<int16_t, CHUNK_SIZE * CHUNK_SIZE> heightMap;
+   heightMap.fill(-1);
+   int sectionType[SECTIONS_PER_CHUNK];
+   bool sectionMixed[SECTIONS_PER_CHUNK] = {};
+   std::fill(std::begin(sectionType), std::end(sectionType), -1);
+
+   uint32_t position = 0;
+   while (position < CHUNK_VOLUME)
+   {
+      if (p >= end)
+         return false;
+      uint8_t index = *p++;
+      uint32_t length;
+      if (index >= paletteSize || !readVarint(p, end, length) || length == 0 || length > CHUNK_VOLUME - position)
+         return false;
+
+      uint8_t id = palette[index];
+      uint32_t runEnd = position + length;
+      std::memset(&columns[position], id, length);
+      while (position < runEnd)
+      {
+         int column = position / CHUNK_HEIGHT;
+         int y = position % CHUNK_HEIGHT;
+         int yEnd = static_cast<int>(std::min<uint32_t>(CHUNK_HEIGHT, y + (runEnd - position)));
+         if (id != static_cast<uint8_t>(BlockType::AIR))
+            heightMap[(column % CHUNK_SIZE) * CHUNK_SIZE + column / CHUNK_SIZE] = static_cast<int16_t>(yEnd - 1);
+         for (int s = y / SECTION_HEIGHT; s <= (yEnd - 1) / SECTION_HEIGHT; s++)
+         {
+            if (sectionType[s] < 0)
+               sectionType[s] = id;
+            else if (sectionType[s] != id)
+               sectionMixed[s] = true;
+         }
+         position += yEnd - y;
+      }
+   }
+   if (p != end)
+      return false;
+
+   // Dati validi: solo ora il chunk viene modificato
+   std::vector<uint8_t> sectionIds(SECTION_VOLUME);
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+   {
+      if (!sectionMixed[s])
+      {
+         chunk.sections[s] = ChunkSection(static_cast<BlockType>(sectionType[s]));
+         continue;
+      }
+      for (int x = 0; x < CHUNK_SIZE; x++)
+         for (int z = 0; z < CHUNK_SIZE; z++)
+         {
+            const uint8_t *column = &columns[(x * CHUNK_SIZE + z) * CHUNK_HEIGHT + s * SECTION_HEIGHT];
+            for (int y = 0; y < SECTION_HEIGHT; y++)
+               sectionIds[ChunkSection::blockIndex(x, y, z)] = column[y];
+         }
+      chunk.sections[s].pack(sectionIds.data());
+   }
+   chunk.heightMap = heightMap;
+   chunk.updateVerticalBounds();
+   return true;
+}
+
+bool ChunkCodec::readDeltaBaseline(const char *data, size_t size, DeltaBaseline &origin)
+{
+   std::vector<uint8_t> storage;
+   const uint8_t *p;
+   const uint8_t *end;
+   return readDeltaBody(data, size, storage, p, end, origin);
+}
+
+bool ChunkCodec::decodeDelta(const char *data, size_t size, const DeltaBaseline &expected, Chunk &chunk)
+{
+   std::vector<uint8_t> storage;
+   const uint8_t *p;
+   const uint8_t *end;
+   DeltaBaseline origin;
+   uint32_t count;
+   if (!readDeltaBody(data, size, storage, p, end, origin) || origin != expected || !readVarint(p, end, count))
+      return false;
+
+   // Posizioni (ordine per colonne) e ID dei blocchi cambiati, validati prima di toccare il chunk
+   std::vector<std::pair<uint32_t, uint8_t>> changes;
+   changes.reserve(std::min<uint32_t>(count, CHUNK_VOLUME));
+   uint32_t next = 0;
+   for (uint32_t i = 0; i < count; i++)
+   {
+      uint32_t gap;
+      if (!readVarint(p, end, gap) || gap >= CHUNK_VOLUME - next || p >= end)
+         return false;
+      uint32_t position = next + gap;
+      changes.emplace_back(position, *p++);
+      next = position + 1;
+   }
+   if (p != end)
+      return false;
+
+   std::vector<uint8_t> ids(CHUNK_VOLUME);
+   chunk.copyToIds(ids.data());
+   for (const auto &change : changes)
+   {
+      int column = change.first / CHUNK_HEIGHT;
+      ids[Chunk::blockIndex(column / CHUNK_SIZE, change.first % CHUNK_HEIGHT, column % CHUNK_SIZE)] = change.second;
+   }
+   chunk.fillFromIds(ids.data());
+   chunk.recomputeBounds();
+   return true;
+}
+
+void ChunkCodec::writeEncoded(const std::vector<uint8_t> &body, uint8_t flags, bool compress, std::vector<char> &out)
+{
+   const std::vector<uint8_t> *payload = &body;
+   std::vector<uint8_t> compressed;
+   if (compress)
+   {
+      compressLz(body.data(), body.size(), compressed);
+      if (compressed.size() < body.size())
+      {
+         flags |= FLAG_LZ;
+         payload = &compressed;
+      }
+   }
+
+   uint32_t bodySize = static_cast<uint32_t>(body.size());
+   out.resize(HEADER_BYTES + payload->size());
+   std::memcpy(out.data(), MAGIC, sizeof(MAGIC));
+   out[3] = static_cast<char>(VERSION);
+   out[4] = static_cast<char>(flags);
+   std::memcpy(out.data() + 5, &bodySize, sizeof(bodySize));
+   std::memcpy(out.data() + HEADER_BYTES, payload->data(), payload->size());
+}
+
+bool ChunkCodec::readBody(const char *data, size_t size, std::vector<uint8_t> &storage,
+                          const uint8_t *&begin, const uint8_t *&end, uint8_t &flags)
+{
+   if (!isEncoded(data, size) || static_cast<uint8_t>(data[3]) == 0 || static_cast<uint8_t>(data[3]) > VERSION)
+      return false;
+
+   flags = static_cast<uint8_t>(data[4]);
+   uint32_t bodySize;
+   std::memcpy(&bodySize, data + 5, sizeof(bodySize));
+   const uint8_t *payload = reinterpret_cast<const uint8_t *>(data) + HEADER_BYTES;
+   size_t payloadSize = size - HEADER_BYTES;
+
+   // Corpo decompresso in storage, o letto direttamente dai dati
+   if (flags & FLAG_LZ)
+   {
+      // Nessun corpo valido supera il formato grezzo
+      if (bodySize > LEGACY_BYTES)
+         return false;
+      storage.resize(bodySize);
+      if (!decompressLz(payload, payloadSize, storage.data(), storage.size()))
+         return false;
+      payload = storage.data();
+      payloadSize = storage.size();
+   }
+   else if (bodySize != payloadSize)
+      return false;
+
+   begin = payload;
+   end = payload + payloadSize;
+   return true;
+}
+
+bool ChunkCodec::readDeltaBody(const char *data, size_t size, std::vector<uint8_t> &storage,
+                               const uint8_t *&begin, const uint8_t *&end, DeltaBaseline &origin)
+{
+   uint8_t flags;
+   if (!readBody(data, size, storage, begin, end, flags) || !(flags & FLAG_DELTA) ||
+       static_cast<uint8_t>(data[3]) < DELTA_BASELINE_VERSION || static_cast<size_t>(end - begin) < sizeof(origin.seed))
+      return false;
+   std::memcpy(&origin.seed, begin, sizeof(origin.seed));
+   begin += sizeof(origin.seed);
+   return readVarint(begin, end, origin.generator);
+}
+
+void ChunkCodec::compressLz(const uint8_t *in, size_t size, std::vector<uint8_t> &out)
+{
+   out.clear();
+   out.reserve(size / 2 + 16);
+
+   std::vector<int32_t> table(size_t(1) << LZ_HASH_BITS, -1);
+   size_t anchor = 0;
+   size_t i = 0;
+   while (i + LZ_MIN_MATCH <= size)
+   {
+      uint32_t sequence = read32(in + i);
+      int32_t &slot = table[lzHash(sequence)];
+      int32_t candidate = slot;
+      slot = static_cast<int32_t>(i);
+      if (candidate < 0 || i - candidate > LZ_MAX_OFFSET || read32(in + candidate) != sequence)
+      {
+         i++;
+         continue;
+      }
+
+      size_t length = LZ_MIN_MATCH;
+      while (i + length < size && in[candidate + length] == in[i + length])
+         length++;
+      writeLzSequence(out, in + anchor, i - anchor, i - candidate, length);
+      i += length;
+      anchor = i;
+   }
+   // Ultima sequenza: solo letterali (anche zero)
+   writeLzSequence(out, in + anchor, size - anchor, 0, 0);
+}
+
+bool ChunkCodec::decompressLz(const uint8_t *in, size_t size, uint8_t *out, size_t outSize)
+{
+   const uint8_t *p = in;
+   const uint8_t *end = in + size;
+   size_t written = 0;
+   while (p < end)
+   {
+      uint8_t token = *p++;
+      size_t literalCount = token >> 4;
+      if (literalCount == 15 && !readLzLength(p, end, literalCount))
+         return false;
+      if (static_cast<size_t>(end - p) < literalCount || outSize - written < literalCount)
+         return false;
+      std::memcpy(out + written, p, literalCount);
+      p += literalCount;
+      written += literalCount;
+      if (p == end)
+         break;
+
+      if (end - p < 2)
+         return false;
+      size_t offset = p[0] | (static_cast<size_t>(p[1]) << 8);
+      p += 2;
+      size_t matchLength = token & 0x0F;
+      if (matchLength == 15 && !readLzLength(p, end, matchLength))
+         return false;
+      matchLength += LZ_MIN_MATCH;
+      if (offset == 0 || offset > written || outSize - written < matchLength)
+         return false;
+
+      // Copia byte per byte: la sorgente può sovrapporsi alla destinazione
+      const uint8_t *source = out + written - offset;
+      for (size_t k = 0; k < matchLength; k++)
+         out[written + k] = source[k];
+      written += matchLength;
+   }
+   return written == outSize;
+}
@@ -0,0 +1,89 @@
+// ================================
+// CODIFICA DEI CHUNK SU DISCO
+// ================================
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Chunk.h"
+
+// Formato compatto dei blocchi di un chunk, versionato.
+// Intestazione: "MGC", versione, flag, lunghezza (uint32) del corpo decompresso.
+// Corpo: palette del chunk (numero di tipi - 1, poi gli ID) seguita dalle run dei blocchi in
+// ordine per colonne (x, z, y come il vecchio formato): per ogni run l'indice nella palette
+// e la lunghezza in varint. Le colonne sono quasi tutte lunghe sequenze di pietra e aria,
+// quindi bastano pochi byte per colonna. Con FLAG_LZ il corpo è compresso con un LZ77
+// semplice (stile LZ4: token, letterali, distanza a 16 bit) che sfrutta le colonne ripetute.
+// Con FLAG_DELTA il corpo contiene solo i blocchi diversi dal chunk rigenerato dal seed:
+// seed (int32) e versione del generatore (varint) del chunk di riferimento, poi numero di
+// blocchi e per ciascuno distanza dal precedente e nuovo ID.
+// La versione 2 aggiunge seed e generatore alle differenze; i chunk completi della versione 1
+// restano leggibili, le differenze della versione 1 no (il riferimento non è verificabile).
+class ChunkCodec
+{
+public:
+   static const uint8_t VERSION = 2;
+   // Prima versione in cui le differenze registrano seed e generatore
+   static const uint8_t DELTA_BASELINE_VERSION = 2;
+   static const uint8_t FLAG_LZ = 1;
+   static const uint8_t FLAG_DELTA = 2;
+   static const size_t HEADER_BYTES = 9;
+
+   // Dimensione dei dati nel vecchio formato grezzo (un int per blocco)
+   static const size_t LEGACY_BYTES = CHUNK_VOLUME * sizeof(int);
+
+   // Codifica i blocchi del chunk in out. Con compress applica anche il passaggio LZ,
+   // che viene tenuto solo se riduce i dati.
+   static void encode(const Chunk &chunk, std::vector<char> &out, bool compress = true);
+
+   // Generatore del chunk di riferimento delle differenze
+   struct DeltaBaseline
+   {
+      int32_t seed = 0;
+      uint32_t generator = Chunk::GENERATOR_VERSION;
+
+      bool operator==(const DeltaBaseline &other) const { return seed == other.seed && generator == other.generator; }
+      bool operator!=(const DeltaBaseline &other) const { return !(*this == other); }
+   };
+
+   // Codifica solo le differenze tra il chunk e baseline (lo stesso chunk appena generato da origin)
+   static void encodeDelta(const Chunk &chunk, const Chunk &baseline, const DeltaBaseline &origin,
+                           std::vector<char> &out, bool compress = true);
+
+   // Vero se i dati iniziano con l'intestazione del formato compatto
+   static bool isEncoded(const char *data, size_t size);
+
+   // Vero se i dati sono differenze da applicare al chunk rigenerato
+   static bool isDelta(const char *data, size_t size);
+
+   // Decodifica i dati direttamente nelle sezioni del chunk, ricostruendo heightmap e limiti
+   // verticali dalle run. Falso (chunk invariato) se i dati sono troncati o non validi.
+   static bool decode(const char *data, size_t size, Chunk &chunk);
+
+   // Legge seed e generatore del chunk di riferimento delle differenze; falso se i dati non sono validi
+   static bool readDeltaBaseline(const char *data, size_t size, DeltaBaseline &origin);
+
+   // Applica le differenze al chunk, che in ingresso contiene il chunk rigenerato da expected;
+   // falso (chunk invariato) se i dati non sono validi o sono riferiti a un altro seed o generatore
+   static bool decodeDelta(const char *data, size_t size, const DeltaBaseline &expected, Chunk &chunk);
+
+   // Passaggio LZ: comprime size byte in out
+   static void compressLz(const uint8_t *in, size_t size, std::vector<uint8_t> &out);
+
+   // Decomprime esattamente outSize byte in out; falso se i dati non sono validi
+   static bool decompressLz(const uint8_t *in, size_t size, uint8_t *out, size_t outSize);
+
+private:
+   // Scrive intestazione e corpo, passando dal LZ se richiesto e conveniente
+   static void writeEncoded(const std::vector<uint8_t> &body, uint8_t flags, bool compress, std::vector<char> &out);
+
+   // Verifica l'intestazione e restituisce il corpo [begin, end), decompresso in storage se serve
+   static bool readBody(const char *data, size_t size, std::vector<uint8_t> &storage,
+                        const uint8_t *&begin, const uint8_t *&end, uint8_t &flags);
+
+   // Corpo delle differenze a partire dal numero di blocchi, dopo seed e generatore letti in origin
+   static bool readDeltaBody(const char *data, size_t size, std::vector<uint8_t> &storage,
+                             const uint8_t *&begin, const uint8_t *&end, DeltaBaseline &origin);
+};
@@ -0,0 +1,134 @@
+// ================================
+// POOL DI GENERAZIONE DEI CHUNK
+// ================================
+#include "ChunkGenerationPool.h"
+
+#include <algorithm>
+#include <iostream>
+
+ChunkGenerationPool::ChunkGenerationPool(int seed, int threadCount) : noise(seed)
+{
+   origin.seed = seed;
+   origin.generator = Chunk::GENERATOR_VERSION;
+
+   if (threadCount <= 0)
+   {
+      int cores = static_cast<int>(std::thread::hardware_concurrency());
+      threadCount = std::max(1, cores - 1);
+   }
+
+   for (int i = 0; i < threadCount; i++)
+      workers.emplace_back(&ChunkGenerationPool::workerLoop, this);
+}
+
+ChunkGenerationPool::~ChunkGenerationPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+      queue.clear();
+   }
+   workAvailable.notify_all();
+   for (std::thread &worker : workers)
+      worker.join();
+}
+
+void ChunkGenerationPool::request(const Point2D &pos, std::vector<char> delta)
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!inFlight.insert(pos).second)
+         return;
+      queue.push_back({pos, std::move(delta)});
+   }
+   workAvailable.notify_one();
+}
+
+bool ChunkGenerationPool::isPending(const Point2D &pos) const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   return inFlight.count(pos) != 0;
+}
+
+void ChunkGenerationPool::setFocus(const Point2D &chunkCoords)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   focus = chunkCoords;
+}
+
+void ChunkGenerationPool::cancelIf(const std::function<bool(const Point2D &)> &shouldCancel)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   auto newEnd = std::remove_if(queue.begin(), queue.end(), [&](const Request &pending)
+                                {
+                                   if (!shouldCancel(pending.pos))
+                                      return false;
+                                   inFlight.erase(pending.pos);
+                                   return true; });
+   queue.erase(newEnd, queue.end());
+   if (queue.empty() && activeJobs == 0)
+      workDone.notify_all();
+}
+
+void ChunkGenerationPool::collect(std::vector<Chunk> &out)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   for (Chunk &chunk : finished)
+   {
+      inFlight.erase(chunk.pos);
+      out.push_back(std::move(chunk));
+   }
+   finished.clear();
+}
+
+void ChunkGenerationPool::waitIdle()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   workDone.wait(lock, [this]
+                 { return queue.empty() && activeJobs == 0; });
+}
+
+size_t ChunkGenerationPool::pendingCount() const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   return inFlight.size();
+}
+
+void ChunkGenerationPool::workerLoop()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   while (true)
+   {
+      workAvailable.wait(lock, [this]
+                         { return stopping || !queue.empty(); });
+      if (stopping)
+         return;
+
+      // Prende la richiesta più vicina al punto di interesse
+      auto distanceToFocus = [this](const Point2D &pos)
+      {
+         float dx = pos.x - focus.x;
+         float dz = pos.z - focus.z;
+         return dx * dx + dz * dz;
+      };
+      auto nearest = std::min_element(queue.begin(), queue.end(), [&](const Request &a, const Request &b)
+                                      { return distanceToFocus(a.pos) < distanceToFocus(b.pos); });
+      Request job = std::move(*nearest);
+      if (nearest != queue.end() - 1)
+         *nearest = std::move(queue.back());
+      queue.pop_back();
+      activeJobs++;
+
+      lock.unlock();
+      Chunk chunk(job.pos);
+      chunk.generate(noise);
+      if (!job.delta.empty() && !ChunkCodec::decodeDelta(job.delta.data(), job.delta.size(), origin, chunk))
+         std::cerr << "Differenze del chunk " << job.pos.x << ", " << job.pos.z << " non valide" << std::endl;
+      lock.lock();
+
+      finished.push_back(std::move(chunk));
+      activeJobs--;
+      if (queue.empty() && activeJobs == 0)
+         workDone.notify_all();
+   }
+}
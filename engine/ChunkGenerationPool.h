@@ -0,0 +1,85 @@
+// ================================
+// POOL DI GENERAZIONE DEI CHUNK
+// ================================
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Core.h"
+#include "Chunk.h"
+#include "ChunkCodec.h"
+#include "PerlinNoise.h"
+
+// Genera i chunk su thread di lavoro, fuori dal thread di rendering.
+// Le richieste in coda vengono servite in ordine di distanza dal punto di interesse
+// (il chunk della camera); i chunk completati restano in attesa finché il thread
+// principale non li raccoglie con collect() per generare la mesh e caricarla sulla GPU.
+// Chunk::generate dipende solo dal seed e dalle coordinate, quindi il risultato è
+// identico bit per bit a quello della generazione sul thread principale.
+// Anche i chunk salvati come differenze passano dal pool: il chunk di riferimento viene
+// rigenerato sul thread di lavoro, che poi vi applica le differenze lette dal disco.
+class ChunkGenerationPool
+{
+public:
+   // threadCount <= 0 usa un thread per core, lasciandone uno al rendering
+   ChunkGenerationPool(int seed, int threadCount = 0);
+   ~ChunkGenerationPool();
+
+   ChunkGenerationPool(const ChunkGenerationPool &) = delete;
+   ChunkGenerationPool &operator=(const ChunkGenerationPool &) = delete;
+
+   // Accoda la generazione del chunk; ignorata se è già in coda, in corso o da raccogliere.
+   // Con delta (dati di ChunkCodec::encodeDelta) le differenze vengono applicate al chunk generato;
+   // se non sono valide o riferite a un altro seed il chunk resta quello generato.
+   void request(const Point2D &pos, std::vector<char> delta = {});
+
+   // Vero se il chunk è stato richiesto e non ancora raccolto
+   bool isPending(const Point2D &pos) const;
+
+   // Imposta il chunk rispetto a cui ordinare le richieste in coda (il più vicino prima)
+   void setFocus(const Point2D &chunkCoords);
+
+   // Rimuove dalla coda le richieste non ancora iniziate per cui shouldCancel restituisce vero
+   void cancelIf(const std::function<bool(const Point2D &)> &shouldCancel);
+
+   // Sposta in out i chunk completati (out non viene svuotato)
+   void collect(std::vector<Chunk> &out);
+
+   // Attende che coda e lavori in corso siano esauriti
+   void waitIdle();
+
+   // Numero di richieste non ancora raccolte (in coda, in corso o completate)
+   size_t pendingCount() const;
+
+   int threadCount() const { return static_cast<int>(workers.size()); }
+
+private:
+   void workerLoop();
+
+   // Richiesta in coda: il chunk da generare e le eventuali differenze da applicare
+   struct Request
+   {
+      Point2D pos;
+      std::vector<char> delta;
+   };
+
+   PerlinNoise noise;
+   ChunkCodec::DeltaBaseline origin; // Seed e generatore di noise, verificati sulle differenze
+   std::vector<std::thread> workers;
+
+   mutable std::mutex mutex;
+   std::condition_variable workAvailable;
+   std::condition_variable workDone;
+   bool stopping = false;
+
+   Point2D focus;
+   std::vector<Request> queue;           // Richieste non ancora iniziate
+   std::unordered_set<Point2D> inFlight; // Richieste non ancora raccolte
+   std::vector<Chunk> finished;          // Chunk completati in attesa di collect()
+   int activeJobs = 0;
+};
@@ -0,0 +1,124 @@
+// ================================
+// INDICE DEI CHUNK SALVATI
+// ================================
+#include "ChunkManifest.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+   // Intestazione del file: "MGM" e versione
+   const char MANIFEST_HEADER[4] = {'M', 'G', 'M', 1};
+   const size_t BITMAP_BYTES = RegionFile::REGION_CHUNKS / 8;
+}
+
+size_t ChunkManifest::bitIndex(const Point2D &chunkPos, const Point2D &regionPos)
+{
+   int localX = static_cast<int>(chunkPos.x - regionPos.x * RegionFile::REGION_SIZE);
+   int localZ = static_cast<int>(chunkPos.z - regionPos.z * RegionFile::REGION_SIZE);
+   return static_cast<size_t>(localZ * RegionFile::REGION_SIZE + localX);
+}
+
+bool ChunkManifest::contains(const Point2D &chunkPos) const
+{
+   Point2D regionPos = RegionFile::regionOf(chunkPos);
+   auto it = regions.find(regionPos);
+   return it != regions.end() && it->second.test(bitIndex(chunkPos, regionPos));
+}
+
+void ChunkManifest::add(const Point2D &chunkPos)
+{
+   Point2D regionPos = RegionFile::regionOf(chunkPos);
+   RegionBits &bits = regions[regionPos];
+   size_t index = bitIndex(chunkPos, regionPos);
+   if (bits.test(index))
+      return;
+   bits.set(index);
+   chunkCount++;
+}
+
+void ChunkManifest::clear()
+{
+   regions.clear();
+   chunkCount = 0;
+}
+
+bool ChunkManifest::load(const std::string &path)
+{
+   clear();
+   std::ifstream file(path, std::ios::binary);
+   char header[sizeof(MANIFEST_HEADER)];
+   uint32_t regionCount;
+   if (!file.read(header, sizeof(header)) || std::memcmp(header, MANIFEST_HEADER, sizeof(header)) != 0 ||
+       !file.read(reinterpret_cast<char *>(&regionCount), sizeof(regionCount)))
+      return false;
+
+   for (uint32_t i = 0; i < regionCount; i++)
+   {
+      int32_t coords[2];
+      uint8_t bitmap[BITMAP_BYTES];
+      if (!file.read(reinterpret_cast<char *>(coords), sizeof(coords)) ||
+          !file.read(reinterpret_cast<char *>(bitmap), sizeof(bitmap)))
+      {
+         clear();
+         return false;
+      }
+      Point2D regionPos(coords[0], coords[1]);
+      RegionBits &bits = regions[regionPos];
+      for (size_t index = 0; index < RegionFile::REGION_CHUNKS; index++)
+         if ((bitmap[index / 8] & (1 << (index % 8))) && !bits.test(index))
+         {
+            bits.set(index);
+            chunkCount++;
+         }
+   }
+   return true;
+}
+
+bool ChunkManifest::save(const std::string &path) const
+{
+   std::string temporaryPath = path + ".tmp";
+   {
+      std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+      uint32_t regionCount = static_cast<uint32_t>(regions.size());
+      file.write(MANIFEST_HEADER, sizeof(MANIFEST_HEADER));
+      file.write(reinterpret_cast<const char *>(&regionCount), sizeof(regionCount));
+      for (const auto &region : regions)
+      {
+         int32_t coords[2] = {static_cast<int32_t>(region.first.x), static_cast<int32_t>(region.first.z)};
+         uint8_t bitmap[BITMAP_BYTES] = {};
+         for (size_t index = 0; index < RegionFile::REGION_CHUNKS; index++)
+            if (region.second.test(index))
+               bitmap[index / 8] |= static_cast<uint8_t>(1 << (index % 8));
+         file.write(reinterpret_cast<const char *>(coords), sizeof(coords));
+         file.write(reinterpret_cast<const char *>(bitmap), sizeof(bitmap));
+      }
+      if (!file)
+         return false;
+   }
+   std::error_code error;
+   fs::rename(temporaryPath, path, error);
+   return !error;
+}
+
+void ChunkManifest::rebuild(const std::string &regionDirectory)
+{
+   clear();
+   std::error_code error;
+   for (const auto &entry : fs::directory_iterator(regionDirectory, error))
+   {
+      std::string filename = entry.path().filename().string();
+      int regionX, regionZ;
+      if (entry.path().extension() != ".mgr" || sscanf(filename.c_str(), "region_%d_%d.mgr", &regionX, &regionZ) != 2)
+         continue;
+      RegionFile region(entry.path().string(), Point2D(regionX, regionZ));
+      for (const Point2D &chunkPos : region.storedChunks())
+         add(chunkPos);
+   }
+}
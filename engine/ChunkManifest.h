@@ -0,0 +1,50 @@
+// ================================
+// INDICE DEI CHUNK SALVATI
+// ================================
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "Core.h"
+#include "RegionFile.h"
+
+// Indice in memoria dei chunk presenti nei file di regione di un mondo: un bit per chunk,
+// una bitmap di REGION_CHUNKS bit per regione. Un chunk assente dall'indice non è su disco
+// e va generato senza aprire né interrogare la sua regione.
+// Alla chiusura del mondo l'indice viene scritto in worlds/<nome>/chunks.manifest ("MGM", versione,
+// numero di regioni, poi per ciascuna coordinate e bitmap); all'apertura viene letto ed eliminato,
+// così dopo un'interruzione manca e va ricostruito dalle tabelle dei file di regione.
+class ChunkManifest
+{
+public:
+   bool contains(const Point2D &chunkPos) const;
+
+   // Segna il chunk come salvato
+   void add(const Point2D &chunkPos);
+
+   // Numero di chunk salvati
+   size_t size() const { return chunkCount; }
+
+   void clear();
+
+   // Legge l'indice dal file; falso (indice vuoto) se il file manca o non è valido
+   bool load(const std::string &path);
+
+   // Scrive l'indice sul file (prima in un file temporaneo, poi rinominato)
+   bool save(const std::string &path) const;
+
+   // Ricostruisce l'indice dalle tabelle dei file di regione della cartella
+   void rebuild(const std::string &regionDirectory);
+
+private:
+   using RegionBits = std::bitset<RegionFile::REGION_CHUNKS>;
+
+   // Posizione del chunk nella bitmap della sua regione (stesso ordine della tabella della regione)
+   static size_t bitIndex(const Point2D &chunkPos, const Point2D &regionPos);
+
+   std::unordered_map<Point2D, RegionBits> regions;
+   size_t chunkCount = 0;
+};
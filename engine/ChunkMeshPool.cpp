@@ -0,0 +1,128 @@
+// ================================
+// POOL DI MESHING DEI CHUNK
+// ================================
+#include "ChunkMeshPool.h"
+
+#include <algorithm>
+
+ChunkMeshPool::ChunkMeshPool(int threadCount)
+{
+   if (threadCount <= 0)
+   {
+      int cores = static_cast<int>(std::thread::hardware_concurrency());
+      threadCount = std::max(1, cores / 2);
+   }
+
+   for (int i = 0; i < threadCount; i++)
+      workers.emplace_back(&ChunkMeshPool::workerLoop, this);
+}
+
+ChunkMeshPool::~ChunkMeshPool()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+      queue.clear();
+   }
+   workAvailable.notify_all();
+   for (std::thread &worker : workers)
+      worker.join();
+}
+
+void ChunkMeshPool::request(MeshSnapshot snapshot)
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto queued = std::find_if(queue.begin(), queue.end(), [&](const MeshSnapshot &pending)
+                                 { return pending.chunk.pos == snapshot.chunk.pos; });
+      if (queued != queue.end())
+      {
+         // La copia più recente vale anche per le sezioni richieste in precedenza
+         snapshot.sectionMask |= queued->sectionMask;
+         *queued = std::move(snapshot);
+         return;
+      }
+      queue.push_back(std::move(snapshot));
+   }
+   workAvailable.notify_one();
+}
+
+void ChunkMeshPool::setFocus(const Point2D &chunkCoords)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   focus = chunkCoords;
+}
+
+void ChunkMeshPool::cancelIf(const std::function<bool(const Point2D &)> &shouldCancel)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   queue.erase(std::remove_if(queue.begin(), queue.end(), [&](const MeshSnapshot &pending)
+                              { return shouldCancel(pending.chunk.pos); }),
+               queue.end());
+   if (queue.empty() && activeJobs == 0)
+      workDone.notify_all();
+}
+
+void ChunkMeshPool::collect(std::vector<MeshedSections> &out)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   for (MeshedSections &meshed : finished)
+      out.push_back(std::move(meshed));
+   finished.clear();
+}
+
+void ChunkMeshPool::waitIdle()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   workDone.wait(lock, [this]
+                 { return queue.empty() && activeJobs == 0; });
+}
+
+size_t ChunkMeshPool::pendingCount() const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   return queue.size() + static_cast<size_t>(activeJobs) + finished.size();
+}
+
+void ChunkMeshPool::workerLoop()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   while (true)
+   {
+      workAvailable.wait(lock, [this]
+                         { return stopping || !queue.empty(); });
+      if (stopping)
+         return;
+
+      // Prende la richiesta più vicina al punto di interesse
+      auto distanceToFocus = [this](const MeshSnapshot &snapshot)
+      {
+         float dx = snapshot.chunk.pos.x - focus.x;
+         float dz = snapshot.chunk.pos.z - focus.z;
+         return dx * dx + dz * dz;
+      };
+      auto nearest = std::min_element(queue.begin(), queue.end(), [&](const MeshSnapshot &a, const MeshSnapshot &b)
+                                      { return distanceToFocus(a) < distanceToFocus(b); });
+      MeshSnapshot snapshot = std::move(*nearest);
+      if (nearest != queue.end() - 1)
+         *nearest = std::move(queue.back());
+      queue.pop_back();
+      activeJobs++;
+
+      lock.unlock();
+      snapshot.chunk.generateMesh(snapshot.mode, &snapshot.border, snapshot.sectionMask);
+      MeshedSections meshed;
+      meshed.pos = snapshot.chunk.pos;
+      meshed.sectionMask = snapshot.sectionMask;
+      meshed.version = snapshot.version;
+      for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+         if (snapshot.sectionMask & (1u << s))
+            meshed.sections[s] = std::move(snapshot.chunk.meshSections[s].data);
+      lock.lock();
+
+      finished.push_back(std::move(meshed));
+      activeJobs--;
+      if (queue.empty() && activeJobs == 0)
+         workDone.notify_all();
+   }
+}
@@ -0,0 +1,87 @@
+// ================================
+// POOL DI MESHING DEI CHUNK
+// ================================
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core.h"
+#include "Chunk.h"
+
+// Copia immutabile di ciò che serve per generare la mesh di un chunk: i suoi blocchi (sezioni,
+// heightmap e limiti verticali, senza mesh) e gli strati dei chunk confinanti che lo circondano.
+// Il thread principale può intanto modificare o scaricare il chunk senza toccare la copia.
+struct MeshSnapshot
+{
+   Chunk chunk;
+   ChunkBorder border;
+   MeshingMode mode = MeshingMode::GREEDY;
+   uint32_t sectionMask = 0;
+   uint64_t version = 0; // Cresce a ogni richiesta (vedi SectionMesh::version)
+};
+
+// Mesh delle sezioni in sectionMask generate da una MeshSnapshot
+struct MeshedSections
+{
+   Point2D pos;
+   uint32_t sectionMask = 0;
+   uint64_t version = 0;
+   std::array<std::vector<uint32_t>, SECTIONS_PER_CHUNK> sections;
+};
+
+// Genera le mesh dei chunk su thread di lavoro, fuori dal thread di rendering.
+// Le richieste in coda vengono servite in ordine di distanza dal punto di interesse (il chunk
+// della camera); una nuova richiesta per un chunk ancora in coda sostituisce la copia in attesa,
+// sommando le sezioni da rigenerare. Le mesh completate restano in attesa finché il thread
+// principale non le raccoglie con collect() e le carica sulla GPU.
+class ChunkMeshPool
+{
+public:
+   // threadCount <= 0 usa metà dei core: il resto va al rendering e al pool di generazione
+   explicit ChunkMeshPool(int threadCount = 0);
+   ~ChunkMeshPool();
+
+   ChunkMeshPool(const ChunkMeshPool &) = delete;
+   ChunkMeshPool &operator=(const ChunkMeshPool &) = delete;
+
+   // Accoda la generazione della mesh descritta dalla copia
+   void request(MeshSnapshot snapshot);
+
+   // Imposta il chunk rispetto a cui ordinare le richieste in coda (il più vicino prima)
+   void setFocus(const Point2D &chunkCoords);
+
+   // Rimuove dalla coda le richieste non ancora iniziate per cui shouldCancel restituisce vero
+   void cancelIf(const std::function<bool(const Point2D &)> &shouldCancel);
+
+   // Sposta in out le mesh completate (out non viene svuotato)
+   void collect(std::vector<MeshedSections> &out);
+
+   // Attende che coda e lavori in corso siano esauriti
+   void waitIdle();
+
+   // Numero di richieste non ancora raccolte (in coda, in corso o completate)
+   size_t pendingCount() const;
+
+   int threadCount() const { return static_cast<int>(workers.size()); }
+
+private:
+   void workerLoop();
+
+   std::vector<std::thread> workers;
+
+   mutable std::mutex mutex;
+   std::condition_variable workAvailable;
+   std::condition_variable workDone;
+   bool stopping = false;
+
+   Point2D focus;
+   std::vector<MeshSnapshot> queue;      // Richieste non ancora iniziate (al più una per chunk)
+   std::vector<MeshedSections> finished; // Mesh completate in attesa di collect()
+   int activeJobs = 0;
+};
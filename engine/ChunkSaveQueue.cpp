@@ -0,0 +1,148 @@
+// ================================
+// CODA DI SALVATAGGIO DEI CHUNK
+// ================================
+#include "ChunkSaveQueue.h"
+
+ChunkSaveQueue::ChunkSaveQueue(WriteFunction write, EncodeFunction encode, std::chrono::milliseconds flushInterval,
+                               FlushHooks hooks)
+    : write(std::move(write)), encode(std::move(encode)), hooks(std::move(hooks)), flushInterval(flushInterval)
+{
+   writer = std::thread(&ChunkSaveQueue::writerLoop, this);
+}
+
+ChunkSaveQueue::~ChunkSaveQueue()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+   wake.notify_all();
+   writer.join();
+}
+
+void ChunkSaveQueue::markDirty(const Chunk &chunk)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   auto inserted = pending.try_emplace(chunk.pos);
+   if (!inserted.second)
+      totals.coalesced++;
+   PendingChunk &entry = inserted.first->second;
+   entry.sections = chunk.sections;
+   entry.version = ++nextVersion;
+}
+
+bool ChunkSaveQueue::readPending(const Point2D &pos, Chunk &chunk) const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   auto it = pending.find(pos);
+   if (it == pending.end())
+      return false;
+   chunk.sections = it->second.sections;
+   chunk.recomputeBounds();
+   return true;
+}
+
+void ChunkSaveQueue::flush()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   if (pending.empty())
+      return;
+   flushRequested = true;
+   wake.notify_all();
+   flushed.wait(lock, [this]
+                { return !flushRequested; });
+}
+
+void ChunkSaveQueue::setFlushInterval(std::chrono::milliseconds interval)
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      flushInterval = interval;
+   }
+   wake.notify_all();
+}
+
+ChunkSaveQueue::Stats ChunkSaveQueue::stats() const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   dropOldWrites();
+
+   Stats result = totals;
+   result.queued = pending.size();
+   result.bytesPerSecond = 0.0;
+   for (const auto &written : recentWrites)
+      result.bytesPerSecond += static_cast<double>(written.second);
+   return result;
+}
+
+void ChunkSaveQueue::dropOldWrites() const
+{
+   auto windowStart = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+   while (!recentWrites.empty() && recentWrites.front().first < windowStart)
+      recentWrites.pop_front();
+}
+
+void ChunkSaveQueue::writerLoop()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   while (true)
+   {
+      // Allo scadere dell'intervallo, su richiesta o alla chiusura: scrive tutto ciò che è in attesa
+      wake.wait_for(lock, flushInterval, [this]
+                    { return stopping || flushRequested; });
+      writePending(lock);
+      flushRequested = false;
+      flushed.notify_all();
+      if (stopping)
+         return;
+   }
+}
+
+void ChunkSaveQueue::writePending(std::unique_lock<std::mutex> &lock)
+{
+   if (hooks.begin)
+      hooks.begin();
+
+   std::vector<Point2D> positions;
+   positions.reserve(pending.size());
+   for (const auto &entry : pending)
+      positions.push_back(entry.first);
+
+   bool allWritten = true;
+   for (const Point2D &pos : positions)
+   {
+      auto it = pending.find(pos);
+      if (it == pending.end())
+         continue;
+      Chunk chunk(pos);
+      chunk.sections = it->second.sections;
+      uint64_t version = it->second.version;
+
+      lock.unlock();
+      std::vector<char> bytes;
+      encode(chunk, bytes);
+      bool written = write(pos, bytes);
+      lock.lock();
+
+      if (!written)
+      {
+         allWritten = false;
+         continue; // Resta in coda: verrà ritentato al prossimo intervallo
+      }
+      totals.chunksWritten++;
+      totals.bytesWritten += bytes.size();
+      recentWrites.emplace_back(std::chrono::steady_clock::now(), bytes.size());
+      dropOldWrites();
+
+      // Se nel frattempo il chunk è stato modificato di nuovo, la copia più recente resta in attesa
+      it = pending.find(pos);
+      if (it != pending.end() && it->second.version == version)
+         pending.erase(it);
+   }
+   if (hooks.end)
+   {
+      lock.unlock();
+      hooks.end(allWritten);
+      lock.lock();
+   }
+}
@@ -0,0 +1,108 @@
+// ================================
+// CODA DI SALVATAGGIO DEI CHUNK
+// ================================
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Core.h"
+#include "Chunk.h"
+
+// Salvataggio differito dei chunk modificati su un thread dedicato.
+// markDirty() copia solo le sezioni del chunk e sostituisce l'eventuale copia già in attesa
+// dello stesso chunk, così più modifiche ravvicinate diventano una sola scrittura.
+// Il thread codifica e scrive le copie in attesa ogni flushInterval (o subito con flush());
+// il distruttore scrive tutto ciò che resta prima di terminare.
+class ChunkSaveQueue
+{
+public:
+   // Scrive i dati codificati del chunk (chiamata dal thread di scrittura)
+   using WriteFunction = std::function<bool(const Point2D &, const std::vector<char> &)>;
+
+   // Codifica i blocchi del chunk nei dati da scrivere (chiamata dal thread di scrittura)
+   using EncodeFunction = std::function<void(const Chunk &, std::vector<char> &)>;
+
+   // Statistiche per il HUD e il benchmark
+   struct Stats
+   {
+      size_t queued = 0;           // Chunk in attesa di scrittura
+      uint64_t chunksWritten = 0;  // Scritture eseguite
+      uint64_t bytesWritten = 0;   // Byte scritti in totale
+      uint64_t coalesced = 0;      // Modifiche assorbite da una copia già in attesa
+      double bytesPerSecond = 0.0; // Byte scritti nell'ultimo secondo
+   };
+
+   // Chiamate dal thread di scrittura attorno a ogni scrittura delle copie in attesa (ad esempio per
+   // un checkpoint del journal). begin viene chiamata con il lock della coda, prima di scegliere i chunk
+   // da scrivere: nessuna modifica può entrare nel frattempo, quindi deve essere veloce.
+   // end viene chiamata dopo le scritture, con vero se sono riuscite tutte.
+   struct FlushHooks
+   {
+      std::function<void()> begin;
+      std::function<void(bool)> end;
+   };
+
+   ChunkSaveQueue(WriteFunction write, EncodeFunction encode, std::chrono::milliseconds flushInterval,
+                  FlushHooks hooks = FlushHooks());
+   ~ChunkSaveQueue();
+
+   ChunkSaveQueue(const ChunkSaveQueue &) = delete;
+   ChunkSaveQueue &operator=(const ChunkSaveQueue &) = delete;
+
+   // Segna il chunk come modificato: la copia dei suoi blocchi verrà scritta al prossimo flush
+   void markDirty(const Chunk &chunk);
+
+   // Copia in chunk i blocchi della versione in attesa (più recente di quella su disco);
+   // falso se il chunk non è in coda
+   bool readPending(const Point2D &pos, Chunk &chunk) const;
+
+   // Scrive subito tutti i chunk in attesa e attende la fine
+   void flush();
+
+   // Intervallo tra due scritture automatiche
+   void setFlushInterval(std::chrono::milliseconds interval);
+
+   Stats stats() const;
+
+private:
+   // Copia dei blocchi di un chunk in attesa; version cambia a ogni markDirty
+   struct PendingChunk
+   {
+      std::vector<ChunkSection> sections;
+      uint64_t version = 0;
+   };
+
+   void writerLoop();
+
+   // Scrive le copie in attesa (il lock viene rilasciato durante codifica e scrittura)
+   void writePending(std::unique_lock<std::mutex> &lock);
+
+   // Scarta da recentWrites le scritture più vecchie di un secondo (con il lock)
+   void dropOldWrites() const;
+
+   WriteFunction write;
+   EncodeFunction encode;
+   FlushHooks hooks;
+   std::thread writer;
+
+   mutable std::mutex mutex;
+   std::condition_variable wake;
+   std::condition_variable flushed;
+   std::chrono::milliseconds flushInterval;
+   bool stopping = false;
+   bool flushRequested = false;
+
+   std::unordered_map<Point2D, PendingChunk> pending;
+   uint64_t nextVersion = 0;
+   Stats totals;
+   // Scritture recenti (istante, byte) per la velocità sull'ultimo secondo
+   mutable std::deque<std::pair<std::chrono::steady_clock::time_point, size_t>> recentWrites;
+};
@@ -0,0 +1,157 @@
+// ================================
+// TIPI E COSTANTI DEL MOTORE
+// ================================
+// Questa parte non dipende da OpenGL/GLUT: viene usata sia dal gioco sia dal benchmark.
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+// ================================
+// COSTANTI GLOBALI
+// ================================
+const int CHUNK_SIZE = 16;
+const int CHUNK_HEIGHT = 256;
+const int RENDER_DISTANCE = 8;
+const int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_HEIGHT;
+const int SECTION_HEIGHT = 16;
+const int SECTION_VOLUME = CHUNK_SIZE * CHUNK_SIZE * SECTION_HEIGHT;
+const int SECTIONS_PER_CHUNK = CHUNK_HEIGHT / SECTION_HEIGHT;
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ================================
+// STRUTTURE E CLASSI
+// ================================
+// Classe Punto
+class Point3D
+{
+public:
+   float x, y, z;
+
+   Point3D(float xPos = 0.0f, float yPos = 0.0f, float zPos = 0.0f) : x(xPos), y(yPos), z(zPos) {}
+
+   void normalize()
+   {
+      float length = std::sqrt(x * x + y * y + z * z);
+      if (length > 0.0f)
+      {
+         x /= length;
+         y /= length;
+         z /= length;
+      }
+   }
+
+   // Operatore == per confrontare due Point3D
+   bool operator==(const Point3D &other) const
+   {
+      return (x == other.x && y == other.y && z == other.z);
+   }
+
+   // Operatore != per confrontare due Point3D
+   bool operator!=(const Point3D &other) const
+   {
+      return !(*this == other);
+   }
+
+   // Operatore + per sommare due Point3D
+   Point3D operator+(const Point3D &other) const
+   {
+      return Point3D(x + other.x, y + other.y, z + other.z);
+   }
+
+   // Operatore * per moltiplicare un Point3D per uno scalare
+   Point3D operator*(float scalar) const
+   {
+      return Point3D(x * scalar, y * scalar, z * scalar);
+   }
+
+   // Operatore * per moltiplicare uno scalare per un Point3D
+   friend Point3D operator*(float scalar, const Point3D &point)
+   {
+      return Point3D(point.x * scalar, point.y * scalar, point.z * scalar);
+   }
+};
+
+class Point2D
+{
+public:
+   float x, z;
+   Point2D(float xPos = 0.0f, float zPos = 0.0f) : x(xPos), z(zPos) {}
+
+   bool operator==(const Point2D &other) const
+   {
+      return (x == other.x && z == other.z);
+   }
+};
+
+// Classe Inclinazione
+class Rotation
+{
+public:
+   float xRot, yRot, zRot;
+   Rotation(float initialXRot = 0.0f, float initialYRot = 0.0f, float initialZRot = 0.0f) : xRot(initialXRot), yRot(initialYRot), zRot(initialZRot) {}
+};
+
+namespace std
+{
+   template <>
+   struct hash<Point2D>
+   {
+      size_t operator()(const Point2D &p) const
+      {
+         // Combinazione hash delle coordinate x e z
+         return hash<float>()(p.x) ^ (hash<float>()(p.z) << 1);
+      }
+   };
+}
+
+// Classe Camera
+class Camera
+{
+public:
+   Point3D pos;
+   Rotation rot;
+
+   Camera(Point3D initialPos = Point3D(0.0f, 0.0f, 0.0f), Rotation initialRot = Rotation(0.0f, 0.0f, 0.0f))
+       : pos(initialPos), rot(initialRot) {}
+
+   void reset()
+   {
+      pos = Point3D(0, 125, 0);
+      rot = Rotation(-30.0f, 45.0f, 0.0f);
+   }
+
+   bool isFaceVisible(const Point3D &blockPos, const Point3D &faceNormalVect) const
+   {
+      Point3D directionVect(blockPos.x - pos.x, blockPos.y - pos.y, blockPos.z - pos.z);
+      directionVect.normalize();
+      float dotProduct = directionVect.x * faceNormalVect.x + directionVect.y * faceNormalVect.y + directionVect.z * faceNormalVect.z;
+      return dotProduct < 0.0f;
+   }
+};
+
+// Enumerazione globale per i tipi di blocco
+// (memorizzata su un byte: è l'ID salvato nell'array dei blocchi del chunk)
+enum class BlockType : uint8_t
+{
+   TEST,        // 00
+   AIR,         // 01
+   GRASS,       // 02
+   DIRT,        // 03
+   STONE,       // 04
+   SAND,        // 05
+   WATER,       // 06
+   BEDROCK,     // 07
+   WOOD,        // 08
+   LEAVES,      // 09
+   PLANKS,      // 10
+   COBBLESTONE, // 11
+   BRICKS,      // 12
+
+   BLOCK_COUNT
+
+};
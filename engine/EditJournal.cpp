@@ -0,0 +1,234 @@
+// ================================
+// JOURNAL DELLE MODIFICHE
+// ================================
+#include "EditJournal.h"
+#include "FileSync.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+   // Intestazione di ogni segmento: "MGJ" e versione
+   const char SEGMENT_HEADER[4] = {'M', 'G', 'J', 1};
+
+   // Record: x e z (int32), y, tipo precedente, tipo nuovo, byte di controllo
+   uint8_t recordCheck(const uint8_t *record)
+   {
+      uint8_t sum = 0x5A;
+      for (size_t i = 0; i < EditJournal::RECORD_BYTES - 1; i++)
+         sum = static_cast<uint8_t>((sum << 1 | sum >> 7) ^ record[i]);
+      return sum;
+   }
+
+   void encodeRecord(const BlockEdit &edit, uint8_t *record)
+   {
+      std::memcpy(record, &edit.x, sizeof(int32_t));
+      std::memcpy(record + 4, &edit.z, sizeof(int32_t));
+      record[8] = static_cast<uint8_t>(edit.y);
+      record[9] = static_cast<uint8_t>(edit.oldType);
+      record[10] = static_cast<uint8_t>(edit.newType);
+      record[11] = recordCheck(record);
+   }
+
+   bool decodeRecord(const uint8_t *record, BlockEdit &edit)
+   {
+      if (record[11] != recordCheck(record))
+         return false;
+      std::memcpy(&edit.x, record, sizeof(int32_t));
+      std::memcpy(&edit.z, record + 4, sizeof(int32_t));
+      edit.y = record[8];
+      edit.oldType = static_cast<BlockType>(record[9]);
+      edit.newType = static_cast<BlockType>(record[10]);
+      return true;
+   }
+}
+
+EditJournal::EditJournal(const std::string &directory, std::chrono::milliseconds syncInterval)
+    : directory(directory), syncInterval(syncInterval)
+{
+   fs::create_directories(directory);
+   std::vector<int> existing = segmentNumbers(directory);
+   segmentNumber = existing.empty() ? 1 : existing.back() + 1;
+   openSegment();
+   syncer = std::thread(&EditJournal::syncLoop, this);
+}
+
+EditJournal::~EditJournal()
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+   }
+   wake.notify_all();
+   syncer.join();
+   sync();
+
+   // I segmenti chiusi di un checkpoint non concluso restano su disco per la prossima apertura
+   for (auto &closed : closedSegments)
+   {
+      syncFileToDisk(closed.second);
+      std::fclose(closed.second);
+   }
+   if (segment)
+   {
+      std::fclose(segment);
+      if (segmentRecords == 0)
+         fs::remove(segmentPath(directory, segmentNumber));
+   }
+}
+
+void EditJournal::append(const BlockEdit &edit)
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   size_t offset = buffer.size();
+   buffer.resize(offset + RECORD_BYTES);
+   encodeRecord(edit, buffer.data() + offset);
+   segmentRecords++;
+   totals.records++;
+}
+
+void EditJournal::sync()
+{
+   std::lock_guard<std::mutex> fileLock(fileMutex);
+   std::FILE *file;
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      writeBuffered();
+      if (!unsynced || !segment)
+         return;
+      unsynced = false;
+      file = segment;
+      totals.syncs++;
+   }
+   // Un checkpoint può cambiare segmento nel frattempo: il file resta aperto fino a completeCheckpoint
+   syncFileToDisk(file);
+}
+
+bool EditJournal::beginCheckpoint()
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   if (segmentRecords == 0 || !segment)
+      return false;
+   writeBuffered();
+   closedSegments.emplace_back(segmentNumber, segment);
+   segmentNumber++;
+   openSegment();
+   return true;
+}
+
+void EditJournal::completeCheckpoint(bool written)
+{
+   std::lock_guard<std::mutex> fileLock(fileMutex);
+   std::vector<std::pair<int, std::FILE *>> closed;
+   int firstOpen;
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+      closed.swap(closedSegments);
+      firstOpen = segmentNumber;
+   }
+
+   for (auto &segmentFile : closed)
+   {
+      if (!written)
+         syncFileToDisk(segmentFile.second);
+      std::fclose(segmentFile.second);
+   }
+   if (!written)
+      return;
+
+   // Anche i segmenti tenuti da checkpoint falliti in precedenza sono ora nelle regioni
+   for (int number : segmentNumbers(directory))
+      if (number < firstOpen)
+         fs::remove(segmentPath(directory, number));
+}
+
+EditJournal::Stats EditJournal::stats() const
+{
+   std::lock_guard<std::mutex> lock(mutex);
+   return totals;
+}
+
+std::vector<BlockEdit> EditJournal::readAll(const std::string &directory)
+{
+   std::vector<BlockEdit> edits;
+   for (int number : segmentNumbers(directory))
+   {
+      std::ifstream file(segmentPath(directory, number), std::ios::binary);
+      char header[sizeof(SEGMENT_HEADER)];
+      if (!file.read(header, sizeof(header)) || std::memcmp(header, SEGMENT_HEADER, sizeof(header)) != 0)
+         continue;
+
+      uint8_t record[RECORD_BYTES];
+      BlockEdit edit;
+      while (file.read(reinterpret_cast<char *>(record), RECORD_BYTES) && decodeRecord(record, edit))
+         edits.push_back(edit);
+   }
+   return edits;
+}
+
+void EditJournal::removeAll(const std::string &directory)
+{
+   for (int number : segmentNumbers(directory))
+      fs::remove(segmentPath(directory, number));
+}
+
+std::vector<int> EditJournal::segmentNumbers(const std::string &directory)
+{
+   std::vector<int> numbers;
+   std::error_code error;
+   for (const auto &entry : fs::directory_iterator(directory, error))
+   {
+      int number;
+      if (entry.path().extension() == ".log" && sscanf(entry.path().filename().string().c_str(), "edits_%d", &number) == 1)
+         numbers.push_back(number);
+   }
+   std::sort(numbers.begin(), numbers.end());
+   return numbers;
+}
+
+std::string EditJournal::segmentPath(const std::string &directory, int number)
+{
+   return (fs::path(directory) / ("edits_" + std::to_string(number) + ".log")).string();
+}
+
+void EditJournal::openSegment()
+{
+   segmentRecords = 0;
+   segment = std::fopen(segmentPath(directory, segmentNumber).c_str(), "wb");
+   if (!segment)
+   {
+      std::cerr << "Impossibile aprire il journal " << segmentPath(directory, segmentNumber) << std::endl;
+      return;
+   }
+   std::fwrite(SEGMENT_HEADER, 1, sizeof(SEGMENT_HEADER), segment);
+   unsynced = true;
+}
+
+void EditJournal::writeBuffered()
+{
+   if (buffer.empty() || !segment)
+      return;
+   std::fwrite(buffer.data(), 1, buffer.size(), segment);
+   std::fflush(segment);
+   buffer.clear();
+   unsynced = true;
+}
+
+void EditJournal::syncLoop()
+{
+   std::unique_lock<std::mutex> lock(mutex);
+   while (!stopping)
+   {
+      wake.wait_for(lock, syncInterval, [this]
+                    { return stopping; });
+      lock.unlock();
+      sync();
+      lock.lock();
+   }
+}
@@ -0,0 +1,105 @@
+// ================================
+// JOURNAL DELLE MODIFICHE
+// ================================
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Core.h"
+
+// Modifica di un blocco, in coordinate globali
+struct BlockEdit
+{
+   int32_t x = 0;
+   int32_t z = 0;
+   int y = 0;
+   BlockType oldType = BlockType::AIR;
+   BlockType newType = BlockType::AIR;
+};
+
+// Journal (write-ahead log) delle modifiche ai blocchi: ogni modifica è un record di RECORD_BYTES
+// aggiunto in fondo al segmento corrente (worlds/<nome>/journal/edits_N.log). append() copia il record
+// in memoria; un thread dedicato scrive i record accumulati e li rende durevoli con un solo fsync
+// ogni syncInterval. Al checkpoint il segmento corrente viene chiuso e ne inizia uno nuovo: quando i
+// chunk modificati sono stati scritti nelle regioni, i segmenti chiusi vengono eliminati.
+// Dopo un'interruzione i segmenti rimasti vengono riletti con readAll() e riapplicati.
+class EditJournal
+{
+public:
+   static const size_t RECORD_BYTES = 12;
+
+   struct Stats
+   {
+      uint64_t records = 0; // Record aggiunti
+      uint64_t syncs = 0;   // fsync eseguiti (uno per lotto)
+   };
+
+   // Apre un nuovo segmento nella cartella, dopo quelli eventualmente già presenti
+   EditJournal(const std::string &directory, std::chrono::milliseconds syncInterval);
+   ~EditJournal();
+
+   EditJournal(const EditJournal &) = delete;
+   EditJournal &operator=(const EditJournal &) = delete;
+
+   // Registra la modifica; diventa durevole entro syncInterval (o con sync())
+   void append(const BlockEdit &edit);
+
+   // Scrive e rende durevoli subito i record accumulati (il fsync non blocca append())
+   void sync();
+
+   // Chiude il segmento corrente e ne apre uno nuovo; falso (nessun checkpoint) se il segmento
+   // corrente è vuoto. Deve essere veloce: viene chiamata mentre la coda di salvataggio è bloccata.
+   bool beginCheckpoint();
+
+   // Conclude il checkpoint: con written i segmenti chiusi vengono eliminati,
+   // altrimenti vengono resi durevoli e tenuti per il prossimo checkpoint
+   void completeCheckpoint(bool written);
+
+   Stats stats() const;
+
+   // Modifiche registrate nei segmenti della cartella, nell'ordine in cui sono state fatte.
+   // La lettura di un segmento si ferma al primo record incompleto o corrotto.
+   static std::vector<BlockEdit> readAll(const std::string &directory);
+
+   // Elimina tutti i segmenti della cartella (dopo averli riapplicati)
+   static void removeAll(const std::string &directory);
+
+private:
+   // Numeri dei segmenti presenti nella cartella, in ordine crescente
+   static std::vector<int> segmentNumbers(const std::string &directory);
+   static std::string segmentPath(const std::string &directory, int number);
+
+   // Apre il segmento successivo (con il lock)
+   void openSegment();
+
+   // Scrive i record accumulati nel segmento corrente (con il lock), senza fsync
+   void writeBuffered();
+
+   void syncLoop();
+
+   std::string directory;
+   std::chrono::milliseconds syncInterval;
+
+   // fileMutex protegge la vita dei file durante un fsync, mutex tutto il resto (ordine: fileMutex, poi mutex)
+   std::mutex fileMutex;
+   mutable std::mutex mutex;
+   std::condition_variable wake;
+   bool stopping = false;
+   std::thread syncer;
+
+   std::FILE *segment = nullptr;
+   int segmentNumber = 0;
+   size_t segmentRecords = 0;   // Record nel segmento corrente
+   // Segmenti chiusi al checkpoint (ancora aperti fino alla sua fine, per i fsync in corso)
+   std::vector<std::pair<int, std::FILE *>> closedSegments;
+   std::vector<uint8_t> buffer; // Record non ancora scritti
+   bool unsynced = false;       // Record scritti nel segmento corrente ma non ancora resi durevoli
+   Stats totals;
+};
@@ -0,0 +1,36 @@
+// ================================
+// SCRITTURA DURABILE SU DISCO
+// ================================
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// Svuota i buffer del file e attende che il sistema operativo lo abbia scritto sul disco
+inline bool syncFileToDisk(std::FILE *file)
+{
+   if (std::fflush(file) != 0)
+      return false;
+#ifdef _WIN32
+   return _commit(_fileno(file)) == 0;
+#else
+   return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Come syncFileToDisk per un file già scritto tramite un altro stream (ad esempio un std::fstream)
+inline bool syncPathToDisk(const std::string &path)
+{
+   std::FILE *file = std::fopen(path.c_str(), "r+b");
+   if (!file)
+      return false;
+   bool synced = syncFileToDisk(file);
+   std::fclose(file);
+   return synced;
+}
@@ -0,0 +1,73 @@
+// ================================
+// FRUSTUM DELLA CAMERA
+// ================================
+#pragma once
+
+#include <array>
+#include <cmath>
+
+#include "Core.h"
+
+// Volume visibile della camera, descritto da sei piani con la normale rivolta verso l'interno.
+// I piani si ricavano dagli stessi parametri passati a gluLookAt e gluPerspective in display(),
+// così un oggetto scartato qui è davvero fuori dallo schermo.
+class Frustum
+{
+public:
+   // Costruisce i piani dalla posizione e dall'inclinazione della camera
+   // (pitch = rot.xRot, yaw = rot.yRot, in gradi) e dalla proiezione prospettica
+   void update(const Camera &camera, float fovYDegrees, float aspect, float nearPlane, float farPlane)
+   {
+      float pitch = camera.rot.xRot * static_cast<float>(M_PI) / 180.0f;
+      float yaw = camera.rot.yRot * static_cast<float>(M_PI) / 180.0f;
+
+      // Base della camera come in gluLookAt: avanti, destra = avanti x su(0,1,0), su = destra x avanti
+      Point3D forward(std::cos(pitch) * std::cos(yaw), std::sin(pitch), std::cos(pitch) * std::sin(yaw));
+      Point3D right(-forward.z, 0.0f, forward.x);
+      right.normalize();
+      Point3D up(right.y * forward.z - right.z * forward.y,
+                 right.z * forward.x - right.x * forward.z,
+                 right.x * forward.y - right.y * forward.x);
+
+      float tanHalfY = std::tan(fovYDegrees * static_cast<float>(M_PI) / 360.0f);
+      float tanHalfX = tanHalfY * aspect;
+
+      // I piani laterali passano per la camera: normale = direzione verso l'interno + tan * avanti
+      const Point3D &eye = camera.pos;
+      planes[0] = planeThrough(right + forward * tanHalfX, eye);        // Sinistra
+      planes[1] = planeThrough(right * -1.0f + forward * tanHalfX, eye); // Destra
+      planes[2] = planeThrough(up + forward * tanHalfY, eye);           // Basso
+      planes[3] = planeThrough(up * -1.0f + forward * tanHalfY, eye);    // Alto
+      planes[4] = planeThrough(forward, eye + forward * nearPlane);      // Vicino
+      planes[5] = planeThrough(forward * -1.0f, eye + forward * farPlane); // Lontano
+   }
+
+   // Falso solo se il box allineato agli assi è interamente fuori da almeno un piano
+   bool intersectsBox(const Point3D &boxMin, const Point3D &boxMax) const
+   {
+      for (const Plane &plane : planes)
+      {
+         // Vertice del box più avanti lungo la normale: se è fuori lui, è fuori tutto il box
+         float x = plane.nx >= 0.0f ? boxMax.x : boxMin.x;
+         float y = plane.ny >= 0.0f ? boxMax.y : boxMin.y;
+         float z = plane.nz >= 0.0f ? boxMax.z : boxMin.z;
+         if (plane.nx * x + plane.ny * y + plane.nz * z + plane.d < 0.0f)
+            return false;
+      }
+      return true;
+   }
+
+private:
+   // Piano n . p + d = 0, con n rivolta verso l'interno del frustum
+   struct Plane
+   {
+      float nx, ny, nz, d;
+   };
+
+   static Plane planeThrough(const Point3D &normal, const Point3D &point)
+   {
+      return {normal.x, normal.y, normal.z, -(normal.x * point.x + normal.y * point.y + normal.z * point.z)};
+   }
+
+   std::array<Plane, 6> planes;
+};
@@ -0,0 +1,274 @@
+// ================================
+// PERLIN NOISE A BLOCCHI (SIMD)
+// ================================
+// Le versioni vettoriali ripetono le operazioni di getNoise nello stesso ordine:
+// niente FMA né riassociazioni, quindi su x86-64 il risultato coincide bit per bit
+// con quello scalare. Le funzioni SSE4.1/AVX2 sono compilate con l'attributo target
+// di GCC, così il resto del programma non richiede flag particolari e l'eseguibile
+// gira anche su CPU senza queste estensioni.
+#include "PerlinNoise.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PERLIN_NOISE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+   // Parte della coordinata y comune a tutto il blocco
+   struct NoiseRow
+   {
+      int YY;
+      float y;
+      float v;
+   };
+
+   NoiseRow makeRow(float y)
+   {
+      NoiseRow row;
+      row.YY = static_cast<int>(std::floor(y)) & 255;
+      row.y = y - std::floor(y);
+      row.v = row.y * row.y * (3.0f - 2.0f * row.y);
+      return row;
+   }
+
+#ifdef PERLIN_NOISE_X86
+
+   // ================================
+   // SSE4.1: 4 punti alla volta
+   // ================================
+
+   __attribute__((target("sse4.1"))) inline __m128 lerp4(__m128 a, __m128 b, __m128 t)
+   {
+      return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+   }
+
+   __attribute__((target("sse4.1"))) inline __m128 smoothstep4(__m128 t)
+   {
+      const __m128 two = _mm_set1_ps(2.0f);
+      const __m128 three = _mm_set1_ps(3.0f);
+      return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(three, _mm_mul_ps(two, t)));
+   }
+
+   // SSE4.1 non ha gather: le quattro letture dalla tabella sono scalari
+   __attribute__((target("sse4.1"))) inline __m128i lookup4(const int *perm, __m128i index)
+   {
+      return _mm_setr_epi32(perm[_mm_cvtsi128_si32(index)], perm[_mm_extract_epi32(index, 1)],
+                            perm[_mm_extract_epi32(index, 2)], perm[_mm_extract_epi32(index, 3)]);
+   }
+
+   __attribute__((target("sse4.1"))) inline __m128 gradient4(__m128i hash, __m128 x, __m128 y, __m128 z)
+   {
+      hash = _mm_and_si128(hash, _mm_set1_epi32(15));
+      // u = hash < 8 ? x : y
+      __m128 hashLow8 = _mm_castsi128_ps(_mm_cmplt_epi32(hash, _mm_set1_epi32(8)));
+      __m128 u = _mm_blendv_ps(y, x, hashLow8);
+      // v = hash < 4 ? y : (hash == 12 || hash == 14 ? x : z)
+      __m128 hashLow4 = _mm_castsi128_ps(_mm_cmplt_epi32(hash, _mm_set1_epi32(4)));
+      __m128 hash12or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(hash, _mm_set1_epi32(12)),
+                                                        _mm_cmpeq_epi32(hash, _mm_set1_epi32(14))));
+      __m128 v = _mm_blendv_ps(_mm_blendv_ps(z, x, hash12or14), y, hashLow4);
+      // Il cambio di segno è uno xor sul bit del segno, identico alla negazione scalare
+      __m128 signU = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(hash, _mm_set1_epi32(1)), 31));
+      __m128 signV = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(hash, _mm_set1_epi32(2)), 30));
+      return _mm_add_ps(_mm_xor_ps(u, signU), _mm_xor_ps(v, signV));
+   }
+
+   __attribute__((target("sse4.1"))) int noiseSse41(const int *perm, const float *xs, const NoiseRow &row,
+                                                    const float *zs, float *out, int count)
+   {
+      const __m128i mask = _mm_set1_epi32(255);
+      const __m128i oneI = _mm_set1_epi32(1);
+      const __m128 one = _mm_set1_ps(1.0f);
+      const __m128i YY = _mm_set1_epi32(row.YY);
+      const __m128 y = _mm_set1_ps(row.y);
+      const __m128 y1 = _mm_sub_ps(y, one);
+      const __m128 v = _mm_set1_ps(row.v);
+
+      int i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+         __m128 x = _mm_loadu_ps(xs + i);
+         __m128 z = _mm_loadu_ps(zs + i);
+         __m128 floorX = _mm_floor_ps(x);
+         __m128 floorZ = _mm_floor_ps(z);
+         __m128i XX = _mm_and_si128(_mm_cvttps_epi32(floorX), mask);
+         __m128i ZZ = _mm_and_si128(_mm_cvttps_epi32(floorZ), mask);
+         x = _mm_sub_ps(x, floorX);
+         z = _mm_sub_ps(z, floorZ);
+
+         __m128 u = smoothstep4(x);
+         __m128 w = smoothstep4(z);
+
+         __m128i A = _mm_add_epi32(lookup4(perm, XX), YY);
+         __m128i AA = _mm_add_epi32(lookup4(perm, _mm_and_si128(A, mask)), ZZ);
+         __m128i AB = _mm_add_epi32(lookup4(perm, _mm_and_si128(_mm_add_epi32(A, oneI), mask)), ZZ);
+         __m128i B = _mm_add_epi32(lookup4(perm, _mm_and_si128(_mm_add_epi32(XX, oneI), mask)), YY);
+         __m128i BA = _mm_add_epi32(lookup4(perm, _mm_and_si128(B, mask)), ZZ);
+         __m128i BB = _mm_add_epi32(lookup4(perm, _mm_and_si128(_mm_add_epi32(B, oneI), mask)), ZZ);
+
+         __m128 x1 = _mm_sub_ps(x, one);
+         __m128 z1 = _mm_sub_ps(z, one);
+
+         __m128 res = lerp4(
+             lerp4(
+                 lerp4(gradient4(lookup4(perm, AA), x, y, z), gradient4(lookup4(perm, BA), x1, y, z), u),
+                 lerp4(gradient4(lookup4(perm, AB), x, y1, z), gradient4(lookup4(perm, BB), x1, y1, z), u), v),
+             lerp4(
+                 lerp4(gradient4(lookup4(perm, _mm_add_epi32(AA, oneI)), x, y, z1),
+                       gradient4(lookup4(perm, _mm_add_epi32(BA, oneI)), x1, y, z1), u),
+                 lerp4(gradient4(lookup4(perm, _mm_add_epi32(AB, oneI)), x, y1, z1),
+                       gradient4(lookup4(perm, _mm_add_epi32(BB, oneI)), x1, y1, z1), u),
+                 v),
+             w);
+         _mm_storeu_ps(out + i, res);
+      }
+      return i;
+   }
+
+   // ================================
+   // AVX2: 8 punti alla volta
+   // ================================
+
+   __attribute__((target("avx2"))) inline __m256 lerp8(__m256 a, __m256 b, __m256 t)
+   {
+      return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+   }
+
+   __attribute__((target("avx2"))) inline __m256 smoothstep8(__m256 t)
+   {
+      const __m256 two = _mm256_set1_ps(2.0f);
+      const __m256 three = _mm256_set1_ps(3.0f);
+      return _mm256_mul_ps(_mm256_mul_ps(t, t), _mm256_sub_ps(three, _mm256_mul_ps(two, t)));
+   }
+
+   __attribute__((target("avx2"))) inline __m256i lookup8(const int *perm, __m256i index)
+   {
+      return _mm256_i32gather_epi32(perm, index, 4);
+   }
+
+   __attribute__((target("avx2"))) inline __m256 gradient8(__m256i hash, __m256 x, __m256 y, __m256 z)
+   {
+      hash = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+      __m256 hashLow8 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), hash));
+      __m256 u = _mm256_blendv_ps(y, x, hashLow8);
+      __m256 hashLow4 = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), hash));
+      __m256 hash12or14 = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(hash, _mm256_set1_epi32(12)),
+                                                              _mm256_cmpeq_epi32(hash, _mm256_set1_epi32(14))));
+      __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(z, x, hash12or14), y, hashLow4);
+      __m256 signU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(1)), 31));
+      __m256 signV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(hash, _mm256_set1_epi32(2)), 30));
+      return _mm256_add_ps(_mm256_xor_ps(u, signU), _mm256_xor_ps(v, signV));
+   }
+
+   __attribute__((target("avx2"))) int noiseAvx2(const int *perm, const float *xs, const NoiseRow &row,
+                                                 const float *zs, float *out, int count)
+   {
+      const __m256i mask = _mm256_set1_epi32(255);
+      const __m256i oneI = _mm256_set1_epi32(1);
+      const __m256 one = _mm256_set1_ps(1.0f);
+      const __m256i YY = _mm256_set1_epi32(row.YY);
+      const __m256 y = _mm256_set1_ps(row.y);
+      const __m256 y1 = _mm256_sub_ps(y, one);
+      const __m256 v = _mm256_set1_ps(row.v);
+
+      int i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         __m256 x = _mm256_loadu_ps(xs + i);
+         __m256 z = _mm256_loadu_ps(zs + i);
+         __m256 floorX = _mm256_floor_ps(x);
+         __m256 floorZ = _mm256_floor_ps(z);
+         __m256i XX = _mm256_and_si256(_mm256_cvttps_epi32(floorX), mask);
+         __m256i ZZ = _mm256_and_si256(_mm256_cvttps_epi32(floorZ), mask);
+         x = _mm256_sub_ps(x, floorX);
+         z = _mm256_sub_ps(z, floorZ);
+
+         __m256 u = smoothstep8(x);
+         __m256 w = smoothstep8(z);
+
+         __m256i A = _mm256_add_epi32(lookup8(perm, XX), YY);
+         __m256i AA = _mm256_add_epi32(lookup8(perm, _mm256_and_si256(A, mask)), ZZ);
+         __m256i AB = _mm256_add_epi32(lookup8(perm, _mm256_and_si256(_mm256_add_epi32(A, oneI), mask)), ZZ);
+         __m256i B = _mm256_add_epi32(lookup8(perm, _mm256_and_si256(_mm256_add_epi32(XX, oneI), mask)), YY);
+         __m256i BA = _mm256_add_epi32(lookup8(perm, _mm256_and_si256(B, mask)), ZZ);
+         __m256i BB = _mm256_add_epi32(lookup8(perm, _mm256_and_si256(_mm256_add_epi32(B, oneI), mask)), ZZ);
+
+         __m256 x1 = _mm256_sub_ps(x, one);
+         __m256 z1 = _mm256_sub_ps(z, one);
+
+         __m256 res = lerp8(
+             lerp8(
+                 lerp8(gradient8(lookup8(perm, AA), x, y, z), gradient8(lookup8(perm, BA), x1, y, z), u),
+                 lerp8(gradient8(lookup8(perm, AB), x, y1, z), gradient8(lookup8(perm, BB), x1, y1, z), u), v),
+             lerp8(
+                 lerp8(gradient8(lookup8(perm, _mm256_add_epi32(AA, oneI)), x, y, z1),
+                       gradient8(lookup8(perm, _mm256_add_epi32(BA, oneI)), x1, y, z1), u),
+                 lerp8(gradient8(lookup8(perm, _mm256_add_epi32(AB, oneI)), x, y1, z1),
+                       gradient8(lookup8(perm, _mm256_add_epi32(BB, oneI)), x1, y1, z1), u),
+                 v),
+             w);
+         _mm256_storeu_ps(out + i, res);
+      }
+      return i;
+   }
+
+#endif // PERLIN_NOISE_X86
+}
+
+void PerlinNoise::getNoiseBatch(const float *xs, float y, const float *zs, float *out, int count, NoiseIsa isa) const
+{
+   int done = 0;
+#ifdef PERLIN_NOISE_X86
+   if (isa != NoiseIsa::SCALAR && isaSupported(isa))
+   {
+      NoiseRow row = makeRow(y);
+      if (isa == NoiseIsa::AVX2)
+         done = noiseAvx2(permutation.data(), xs, row, zs, out, count);
+      else
+         done = noiseSse41(permutation.data(), xs, row, zs, out, count);
+   }
+#endif
+   // Punti rimasti (o tutti, senza estensioni): versione scalare
+   for (int i = done; i < count; i++)
+      out[i] = getNoise(xs[i], y, zs[i]);
+}
+
+bool PerlinNoise::isaSupported(NoiseIsa isa)
+{
+   switch (isa)
+   {
+   case NoiseIsa::SCALAR:
+      return true;
+#ifdef PERLIN_NOISE_X86
+   case NoiseIsa::SSE41:
+      return __builtin_cpu_supports("sse4.1");
+   case NoiseIsa::AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+   default:
+      return false;
+   }
+}
+
+NoiseIsa PerlinNoise::bestIsa()
+{
+   // Rilevato una sola volta: la CPU non cambia durante l'esecuzione
+   static const NoiseIsa best = isaSupported(NoiseIsa::AVX2)    ? NoiseIsa::AVX2
+                                : isaSupported(NoiseIsa::SSE41) ? NoiseIsa::SSE41
+                                                                : NoiseIsa::SCALAR;
+   return best;
+}
+
+const char *PerlinNoise::isaName(NoiseIsa isa)
+{
+   switch (isa)
+   {
+   case NoiseIsa::SSE41:
+      return "sse4.1";
+   case NoiseIsa::AVX2:
+      return "avx2";
+   default:
+      return "scalar";
+   }
+}
@@ -0,0 +1,132 @@
+// ================================
+// PERLIN NOISE
+// ================================
+#pragma once
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+// Set di istruzioni usabili per la valutazione a blocchi del rumore
+enum class NoiseIsa
+{
+   SCALAR, // Nessuna estensione: un punto alla volta
+   SSE41,  // 4 punti per istruzione
+   AVX2    // 8 punti per istruzione, con gather per la tabella di permutazione
+};
+
+class PerlinNoise
+{
+private:
+   int seed;
+   std::vector<int> permutation;
+
+   // Funzione per generare una tabella di permutazione pseudocasuale
+   void generatePermutation()
+   {
+      std::mt19937 generator(seed);
+      permutation.resize(512);
+      for (int i = 0; i < 256; ++i)
+      {
+         permutation[i] = i;
+      }
+      std::shuffle(permutation.begin(), permutation.begin() + 256, generator);
+      // Duplica la tabella per evitare controlli di wrapping
+      for (int i = 0; i < 256; i++)
+      {
+         permutation[256 + i] = permutation[i];
+      }
+   }
+
+   // Funzione per interpolare con un polinomio smoothstep
+   float smoothstep(float t) const
+   {
+      return t * t * (3.0f - 2.0f * t);
+   }
+
+   // Funzione per interpolare linearmente tra due valori
+   float lerp(float a, float b, float t) const
+   {
+      return a + t * (b - a);
+   }
+
+   // Funzione per ottenere il gradiente in un punto della griglia
+   float gradient(int hash, float x, float y, float z) const
+   {
+      hash = hash & 15; // Limita hash a 0-15
+      float u = (hash < 8) ? x : y;
+      float v = (hash < 4) ? y : ((hash == 12 || hash == 14) ? x : z);
+      return ((hash & 1) == 0 ? u : -u) + ((hash & 2) == 0 ? v : -v);
+   }
+
+public:
+   PerlinNoise(int seedValue) : seed(seedValue)
+   {
+      generatePermutation();
+   }
+
+   // Funzione principale per calcolare il Perlin Noise
+   float getNoise(float x, float y, float z) const
+   {
+      // Trova la cella della griglia contenente il punto (x, y, z)
+      int X = static_cast<int>(std::floor(x));
+      int Y = static_cast<int>(std::floor(y));
+      int Z = static_cast<int>(std::floor(z));
+
+      // Usa un sistema di coordinate che gestisce correttamente i negativi
+      int XX = X & 255;
+      int YY = Y & 255;
+      int ZZ = Z & 255;
+
+      x -= std::floor(x);
+      y -= std::floor(y);
+      z -= std::floor(z);
+
+      // Interpolazione smoothstep
+      float u = smoothstep(x);
+      float v = smoothstep(y);
+      float w = smoothstep(z);
+
+      // Hash delle coordinate della griglia
+      int A = permutation[XX] + YY;
+      int AA = permutation[A & 255] + ZZ;
+      int AB = permutation[(A + 1) & 255] + ZZ;
+      int B = permutation[(XX + 1) & 255] + YY;
+      int BA = permutation[B & 255] + ZZ;
+      int BB = permutation[(B + 1) & 255] + ZZ;
+
+      // Combina i risultati dei gradienti
+      float res = lerp(
+          lerp(
+              lerp(gradient(permutation[AA], x, y, z), gradient(permutation[BA], x - 1, y, z), u),
+              lerp(gradient(permutation[AB], x, y - 1, z), gradient(permutation[BB], x - 1, y - 1, z), u), v),
+          lerp(
+              lerp(gradient(permutation[AA + 1], x, y, z - 1), gradient(permutation[BA + 1], x - 1, y, z - 1), u),
+              lerp(gradient(permutation[AB + 1], x, y - 1, z - 1), gradient(permutation[BB + 1], x - 1, y - 1, z - 1), u), v),
+          w);
+
+      return res;
+   }
+
+   // Calcola il rumore in count punti (xs[i], y, zs[i]) scrivendo i risultati in out.
+   // Usa il miglior set di istruzioni disponibile sulla CPU, scelto una volta sola a runtime;
+   // le operazioni sono le stesse della versione scalare, nello stesso ordine e senza FMA.
+   void getNoiseBatch(const float *xs, float y, const float *zs, float *out, int count) const
+   {
+      getNoiseBatch(xs, y, zs, out, count, bestIsa());
+   }
+
+   // Come sopra, ma con un set di istruzioni esplicito (per test e benchmark).
+   // Se la CPU non supporta isa si ricade sulla versione scalare.
+   void getNoiseBatch(const float *xs, float y, const float *zs, float *out, int count, NoiseIsa isa) const;
+
+   // Vero se la CPU supporta il set di istruzioni indicato
+   static bool isaSupported(NoiseIsa isa);
+
+   // Miglior set di istruzioni supportato dalla CPU
+   static NoiseIsa bestIsa();
+
+   // Nome del set di istruzioni (per i report)
+   static const char *isaName(NoiseIsa isa);
+};
@@ -0,0 +1,190 @@
+// ================================
+// FILE DI REGIONE
+// ================================
+#include "RegionFile.h"
+#include "FileSync.h"
+
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+Point2D RegionFile::regionOf(const Point2D &chunkPos)
+{
+   return Point2D(std::floor(chunkPos.x / REGION_SIZE), std::floor(chunkPos.z / REGION_SIZE));
+}
+
+std::string RegionFile::fileName(const Point2D &regionPos)
+{
+   std::stringstream name;
+   name << "region_" << static_cast<int>(regionPos.x) << "_" << static_cast<int>(regionPos.z) << ".mgr";
+   return name.str();
+}
+
+RegionFile::RegionFile(const std::string &path, const Point2D &regionPos) : path(path), region(regionPos)
+{
+   header.fill({0, 0});
+   usedSectors.assign(HEADER_SECTORS, true);
+
+   file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+   if (!file.is_open())
+      return; // Manca, o non si apre: create() lo distingue alla prima scrittura
+
+   file.read(reinterpret_cast<char *>(header.data()), HEADER_BYTES);
+   if (!file)
+   {
+      // Tabella troncata: i chunk non sono leggibili, ma il file resta com'è (niente scritture)
+      std::cerr << "Tabella della regione " << path << " non valida" << std::endl;
+      header.fill({0, 0});
+      file.close();
+      unreadable = true;
+      return;
+   }
+
+   // Scarta le voci che puntano dentro la tabella o oltre la fine del file
+   file.seekg(0, std::ios::end);
+   uint64_t fileSectors = static_cast<uint64_t>(file.tellg()) / SECTOR_BYTES;
+   for (Entry &entry : header)
+   {
+      if (entry.sector != 0 &&
+          (entry.sector < HEADER_SECTORS || entry.sector + static_cast<uint64_t>(sectorsFor(entry.bytes)) > fileSectors))
+         entry = {0, 0};
+      markSectors(entry, true);
+   }
+}
+
+int RegionFile::entryIndex(const Point2D &chunkPos) const
+{
+   int localX = static_cast<int>(chunkPos.x - region.x * REGION_SIZE);
+   int localZ = static_cast<int>(chunkPos.z - region.z * REGION_SIZE);
+   return localZ * REGION_SIZE + localX;
+}
+
+bool RegionFile::contains(const Point2D &chunkPos) const
+{
+   return header[entryIndex(chunkPos)].sector != 0;
+}
+
+bool RegionFile::read(const Point2D &chunkPos, std::vector<char> &payload)
+{
+   const Entry &entry = header[entryIndex(chunkPos)];
+   if (entry.sector == 0 || !file.is_open())
+      return false;
+
+   payload.resize(entry.bytes);
+   file.clear();
+   file.seekg(static_cast<std::streamoff>(entry.sector) * SECTOR_BYTES);
+   file.read(payload.data(), entry.bytes);
+   return static_cast<bool>(file);
+}
+
+bool RegionFile::write(const Point2D &chunkPos, const char *data, size_t size)
+{
+   if (!file.is_open() && (unreadable || !create()))
+      return false;
+
+   int index = entryIndex(chunkPos);
+   const Entry previous = header[index];
+   uint32_t needed = sectorsFor(size);
+
+   // Stesso posto se i dati ci stanno ancora, altrimenti il primo spazio libero
+   // (cercato prima di liberare i vecchi settori, che restano intatti fino all'aggiornamento della voce)
+   bool inPlace = previous.sector != 0 && sectorsFor(previous.bytes) >= needed;
+   Entry entry;
+   entry.sector = inPlace ? previous.sector : findFreeSectors(needed);
+   entry.bytes = static_cast<uint32_t>(size);
+   markSectors(previous, false);
+   markSectors(entry, true);
+
+   // Dati completati fino al confine del settore, poi la voce nella tabella
+   file.clear();
+   file.seekp(static_cast<std::streamoff>(entry.sector) * SECTOR_BYTES);
+   file.write(data, size);
+   size_t padding = needed * SECTOR_BYTES - size;
+   if (padding > 0)
+   {
+      static const char zeros[SECTOR_BYTES] = {};
+      file.write(zeros, padding);
+   }
+   file.flush();
+
+   header[index] = entry;
+   file.seekp(static_cast<std::streamoff>(index) * sizeof(Entry));
+   file.write(reinterpret_cast<const char *>(&entry), sizeof(Entry));
+   file.flush();
+   unsynced = true;
+   return static_cast<bool>(file);
+}
+
+bool RegionFile::sync()
+{
+   if (!unsynced)
+      return true;
+   // Il fstream non espone il descrittore: i dati già passati al sistema vengono sincronizzati dal percorso
+   unsynced = !syncPathToDisk(path);
+   return !unsynced;
+}
+
+std::vector<Point2D> RegionFile::storedChunks() const
+{
+   std::vector<Point2D> chunks;
+   for (int index = 0; index < REGION_CHUNKS; index++)
+   {
+      if (header[index].sector == 0)
+         continue;
+      chunks.emplace_back(region.x * REGION_SIZE + index % REGION_SIZE, region.z * REGION_SIZE + index / REGION_SIZE);
+   }
+   return chunks;
+}
+
+bool RegionFile::create()
+{
+   // Un file esistente che il costruttore non ha aperto (permessi, file bloccato) non va troncato
+   std::error_code error;
+   if (std::filesystem::exists(path, error) || error)
+   {
+      std::cerr << "Impossibile aprire la regione " << path << ": non viene ricreata" << std::endl;
+      unreadable = true;
+      return false;
+   }
+   {
+      std::ofstream created(path, std::ios::binary | std::ios::trunc);
+      if (!created.is_open())
+         return false;
+      std::vector<char> emptyHeader(HEADER_SECTORS * SECTOR_BYTES, 0);
+      created.write(emptyHeader.data(), emptyHeader.size());
+   }
+   file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+   return file.is_open();
+}
+
+void RegionFile::markSectors(const Entry &entry, bool used)
+{
+   if (entry.sector == 0)
+      return;
+   uint32_t end = entry.sector + sectorsFor(entry.bytes);
+   if (usedSectors.size() < end)
+      usedSectors.resize(end, false);
+   for (uint32_t sector = entry.sector; sector < end; sector++)
+      usedSectors[sector] = used;
+}
+
+uint32_t RegionFile::findFreeSectors(uint32_t count) const
+{
+   uint32_t runStart = 0;
+   uint32_t runLength = 0;
+   for (uint32_t sector = HEADER_SECTORS; sector < usedSectors.size(); sector++)
+   {
+      if (usedSectors[sector])
+      {
+         runLength = 0;
+         continue;
+      }
+      if (runLength == 0)
+         runStart = sector;
+      if (++runLength == count)
+         return runStart;
+   }
+   // Nessuno spazio abbastanza grande: in fondo al file (estendendo un'eventuale coda libera)
+   return runLength > 0 ? runStart : static_cast<uint32_t>(usedSectors.size());
+}
@@ -0,0 +1,92 @@
+// ================================
+// FILE DI REGIONE
+// ================================
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Core.h"
+
+// Contenitore su disco per REGION_SIZE x REGION_SIZE chunk (worlds/<nome>/region/region_RX_RZ.mgr).
+// Il file inizia con una tabella di REGION_SIZE^2 voci (primo settore e lunghezza in byte del
+// chunk, zero se assente) seguita dai dati dei chunk, ciascuno allineato a settori da SECTOR_BYTES.
+// Un chunk riscritto resta al suo posto se ci sta ancora, altrimenti occupa il primo spazio
+// libero abbastanza grande o viene aggiunto in fondo. Un chunk spostato viene scritto prima
+// di aggiornarne la voce nella tabella, così un'interruzione lascia valida la versione precedente.
+class RegionFile
+{
+public:
+   static const int REGION_SIZE = 32;
+   static const int REGION_CHUNKS = REGION_SIZE * REGION_SIZE;
+   static const size_t SECTOR_BYTES = 4096;
+
+   // Coordinate della regione che contiene il chunk
+   static Point2D regionOf(const Point2D &chunkPos);
+
+   // Nome del file della regione (senza cartella)
+   static std::string fileName(const Point2D &regionPos);
+
+   // Apre il file se esiste e ne legge la tabella; altrimenti la regione è vuota
+   // e il file viene creato alla prima scrittura. Un file esistente che non si riesce ad aprire
+   // o con la tabella troncata non viene mai ricreato: la regione risulta vuota e le scritture falliscono.
+   RegionFile(const std::string &path, const Point2D &regionPos);
+
+   RegionFile(const RegionFile &) = delete;
+   RegionFile &operator=(const RegionFile &) = delete;
+
+   // Vero se la regione contiene il chunk
+   bool contains(const Point2D &chunkPos) const;
+
+   // Legge i dati del chunk; falso se non è presente o la lettura fallisce
+   bool read(const Point2D &chunkPos, std::vector<char> &payload);
+
+   // Scrive i dati del chunk, riscrivendoli al loro posto se possibile; falso se il file non è
+   // scrivibile (compreso un file esistente ma illeggibile, che non viene sovrascritto)
+   bool write(const Point2D &chunkPos, const char *data, size_t size);
+
+   // Coordinate dei chunk presenti nella regione
+   std::vector<Point2D> storedChunks() const;
+
+   // Attende che le scritture fatte dall'ultima chiamata siano sul disco (per i checkpoint del journal)
+   bool sync();
+
+private:
+   struct Entry
+   {
+      uint32_t sector; // Primo settore dei dati (0: chunk assente, i settori iniziali sono la tabella)
+      uint32_t bytes;  // Lunghezza dei dati
+   };
+
+   static const size_t HEADER_BYTES = REGION_CHUNKS * sizeof(Entry);
+   static const uint32_t HEADER_SECTORS = static_cast<uint32_t>((HEADER_BYTES + SECTOR_BYTES - 1) / SECTOR_BYTES);
+
+   static uint32_t sectorsFor(size_t bytes)
+   {
+      return static_cast<uint32_t>((bytes + SECTOR_BYTES - 1) / SECTOR_BYTES);
+   }
+
+   // Indice della voce del chunk nella tabella
+   int entryIndex(const Point2D &chunkPos) const;
+
+   // Crea il file con una tabella vuota (solo se il file non esiste)
+   bool create();
+
+   // Segna come occupati (o liberi) i settori di una voce
+   void markSectors(const Entry &entry, bool used);
+
+   // Primo settore di una sequenza libera di count settori (eventualmente in fondo al file)
+   uint32_t findFreeSectors(uint32_t count) const;
+
+   std::string path;
+   std::fstream file;
+   Point2D region;
+   std::array<Entry, REGION_CHUNKS> header;
+   std::vector<bool> usedSectors; // Settori occupati da tabella e dati, uno per settore del file
+   bool unsynced = false;         // Scritture non ancora rese durevoli con sync()
+   bool unreadable = false;       // Il file esiste ma non è stato aperto o letto: non va ricreato
+};
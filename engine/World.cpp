@@ -0,0 +1,992 @@
+// ================================
+// MONDO
+// ================================
+#include "World.h"
+#include "ChunkCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Stream in sola lettura sopra un buffer già in memoria (i dati letti da una regione), senza copiarlo
+struct MemoryReadBuffer : std::streambuf
+{
+   MemoryReadBuffer(char *data, size_t size)
+   {
+      setg(data, data, data + size);
+   }
+};
+
+// Spostamento (dx, dz) verso il chunk confinante su ciascun lato (stesso ordine di CHUNK_SIDES)
+static const int SIDE_OFFSETS[CHUNK_SIDES][2] = {{0, 1}, {0, -1}, {-1, 0}, {1, 0}};
+
+Point2D World::getChunkCoordinates(const Point3D &pos) const
+{
+   return Point2D(std::floor(pos.x / CHUNK_SIZE), std::floor(pos.z / CHUNK_SIZE));
+}
+
+int World::surfaceHeightAt(int worldX, int worldZ) const
+{
+   int chunkX = static_cast<int>(std::floor(worldX / static_cast<float>(CHUNK_SIZE)));
+   int chunkZ = static_cast<int>(std::floor(worldZ / static_cast<float>(CHUNK_SIZE)));
+   auto it = chunksMap.find(Point2D(chunkX, chunkZ));
+   if (it == chunksMap.end())
+      return -1;
+   return it->second.columnHeight(worldX - chunkX * CHUNK_SIZE, worldZ - chunkZ * CHUNK_SIZE);
+}
+
+void World::resetCamera()
+{
+   camera.reset();
+   spawnPoint = camera.pos;
+   int groundHeight = surfaceHeightAt(static_cast<int>(std::round(spawnPoint.x)), static_cast<int>(std::round(spawnPoint.z)));
+   if (spawnPoint.y < groundHeight + 2)
+      spawnPoint.y = static_cast<float>(groundHeight + 2);
+   camera.pos = spawnPoint;
+}
+
+// Posizione di (dx, dz) nella spirale quadrata che parte dal centro e percorre un anello alla volta
+static int spiralIndex(int dx, int dz)
+{
+   int ring = std::max(std::abs(dx), std::abs(dz));
+   if (ring == 0)
+      return 0;
+   int first = (2 * ring - 1) * (2 * ring - 1); // Celle degli anelli interni
+   int side = 2 * ring;
+   if (dx == ring && dz > -ring)
+      return first + (dz + ring - 1); // Lato +x, z crescente
+   if (dz == ring && dx < ring)
+      return first + side + (ring - 1 - dx); // Lato +z, x decrescente
+   if (dx == -ring && dz < ring)
+      return first + 2 * side + (ring - 1 - dz); // Lato -x, z decrescente
+   return first + 3 * side + (dx + ring - 1); // Lato -z, x crescente
+}
+
+// Vero se pos cade nel quadrato di chunk di centro center e raggio radius
+static bool insideArea(const Point2D &pos, const Point2D &center, int radius)
+{
+   return std::fabs(pos.x - center.x) <= radius && std::fabs(pos.z - center.z) <= radius;
+}
+
+// Chiama visit per ogni chunk del quadrato (a, radius) che non cade nel quadrato (b, radius):
+// le strisce di colonne e di righe che differiscono, senza scorrere la parte comune
+template <typename Visit>
+static void forEachOutside(const Point2D &a, const Point2D &b, int radius, Visit visit)
+{
+   int ax = static_cast<int>(a.x), az = static_cast<int>(a.z);
+   int bx = static_cast<int>(b.x), bz = static_cast<int>(b.z);
+   for (int x = ax - radius; x <= ax + radius; x++)
+   {
+      if (x < bx - radius || x > bx + radius)
+      {
+         for (int z = az - radius; z <= az + radius; z++)
+            visit(Point2D(x, z));
+         continue;
+      }
+      for (int z = az - radius; z <= std::min(az + radius, bz - radius - 1); z++)
+         visit(Point2D(x, z));
+      for (int z = std::max(az - radius, bz + radius + 1); z <= az + radius; z++)
+         visit(Point2D(x, z));
+   }
+}
+
+void World::updateVisibleChunks(const Camera &camera, int renderDistance)
+{
+   // Finché la camera resta nello stesso chunk l'area visibile non cambia
+   Point2D currentChunkCoords = getChunkCoordinates(camera.pos);
+   if (renderDistance != visibleRadius || !(currentChunkCoords == visibleCenter))
+      moveVisibleArea(currentChunkCoords, renderDistance);
+
+   // Inserisce i chunk completati dai thread di generazione, poi smaltisce parte della coda
+   integrateGeneratedChunks();
+   loadPendingChunks();
+   integrateMeshes();
+}
+
+bool World::isVisibleAreaLoaded() const
+{
+   if (visibleRadius < 0 || !pendingLoads.empty())
+      return false;
+   int centerX = static_cast<int>(visibleCenter.x), centerZ = static_cast<int>(visibleCenter.z);
+   for (int x = centerX - visibleRadius; x <= centerX + visibleRadius; x++)
+      for (int z = centerZ - visibleRadius; z <= centerZ + visibleRadius; z++)
+         if (chunksMap.find(Point2D(x, z)) == chunksMap.end())
+            return false;
+   return true;
+}
+
+void World::moveVisibleArea(const Point2D &center, int radius)
+{
+   Point2D previousCenter = visibleCenter;
+   int previousRadius = visibleRadius;
+   visibleCenter = center;
+   visibleRadius = radius;
+
+   auto evict = [this](const Point2D &pos)
+   {
+      auto it = chunksMap.find(pos);
+      if (it == chunksMap.end())
+         return;
+      unloadChunk(pos);
+      chunksMap.erase(it);
+   };
+   auto enqueue = [this](const Point2D &pos)
+   {
+      pendingLoads.push_back(pos);
+   };
+
+   bool overlapping = previousRadius == radius &&
+                      std::fabs(center.x - previousCenter.x) <= 2 * radius &&
+                      std::fabs(center.z - previousCenter.z) <= 2 * radius;
+   if (overlapping)
+   {
+      // Solo le strisce che escono e quelle che entrano
+      forEachOutside(previousCenter, center, radius, evict);
+      forEachOutside(center, previousCenter, radius, enqueue);
+   }
+   else
+   {
+      // Primo aggiornamento, salto della camera o nuova render distance: si ricalcola tutto
+      for (auto it = chunksMap.begin(); it != chunksMap.end();)
+      {
+         if (!insideArea(it->first, center, radius))
+         {
+            unloadChunk(it->first);
+            it = chunksMap.erase(it);
+         }
+         else
+         {
+            ++it;
+         }
+      }
+      pendingLoads.clear();
+      for (int dx = -radius; dx <= radius; ++dx)
+         for (int dz = -radius; dz <= radius; ++dz)
+            enqueue(Point2D(center.x + dx, center.z + dz));
+   }
+
+   // La coda resta ordinata a spirale attorno al nuovo centro, senza i chunk usciti
+   pendingLoads.erase(std::remove_if(pendingLoads.begin(), pendingLoads.end(), [&](const Point2D &pos)
+                                     { return !insideArea(pos, center, radius); }),
+                      pendingLoads.end());
+   auto spiralKey = [&center](const Point2D &pos)
+   {
+      return spiralIndex(static_cast<int>(pos.x - center.x), static_cast<int>(pos.z - center.z));
+   };
+   std::sort(pendingLoads.begin(), pendingLoads.end(), [&](const Point2D &a, const Point2D &b)
+             { return spiralKey(a) < spiralKey(b); });
+
+   // Dà priorità ai chunk vicini alla camera e annulla le richieste non ancora iniziate che sono uscite
+   generator().setFocus(center);
+   generator().cancelIf([&](const Point2D &pos)
+                        { return !insideArea(pos, center, radius); });
+   if (meshPool)
+   {
+      meshPool->setFocus(center);
+      meshPool->cancelIf([&](const Point2D &pos)
+                         { return !insideArea(pos, center, radius); });
+   }
+}
+
+void World::loadPendingChunks()
+{
+   std::vector<Point2D> loaded;
+   int diskLoads = 0;
+   size_t next = 0;
+   while (next < pendingLoads.size() && diskLoads < maxChunkLoadsPerFrame)
+   {
+      Point2D chunkCoords = pendingLoads[next++];
+      if (chunksMap.find(chunkCoords) != chunksMap.end() || generator().isPending(chunkCoords))
+         continue;
+
+      Chunk chunk(chunkCoords);
+      std::vector<char> delta;
+      if (!loadChunk(chunkCoords, chunk, &delta))
+      {
+         generateChunk(chunkCoords);
+         continue;
+      }
+      diskLoads++;
+      if (!delta.empty())
+      {
+         // Il chunk di riferimento delle differenze si rigenera sul pool, come un chunk nuovo
+         generator().request(chunkCoords, std::move(delta));
+         continue;
+      }
+      chunksMap[chunkCoords] = std::move(chunk);
+      loaded.push_back(chunkCoords);
+   }
+   pendingLoads.erase(pendingLoads.begin(), pendingLoads.begin() + next);
+
+   meshNewChunks(loaded);
+}
+
+void World::setMeshingMode(MeshingMode mode)
+{
+   meshingMode = mode;
+   for (auto &chunkPair : chunksMap)
+      meshChunk(chunkPair.second);
+}
+
+ChunkBorder World::borderOf(const Point2D &pos) const
+{
+   ChunkBorder border;
+   for (int side = 0; side < CHUNK_SIDES; side++)
+   {
+      auto it = chunksMap.find(Point2D(pos.x + SIDE_OFFSETS[side][0], pos.z + SIDE_OFFSETS[side][1]));
+      if (it != chunksMap.end())
+         border.setSide(side, it->second);
+   }
+   return border;
+}
+
+void World::meshChunk(Chunk &chunk, uint32_t sectionMask)
+{
+   // Da ora le mesh di richieste precedenti per queste sezioni vengono scartate
+   uint64_t version = ++meshVersion;
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+      if (sectionMask & (1u << s))
+         chunk.meshSections[s].requestedVersion = version;
+
+   ChunkBorder border = borderOf(chunk.pos);
+   if (!asyncMeshing)
+   {
+      chunk.generateMesh(meshingMode, &border, sectionMask);
+      for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+         if (sectionMask & (1u << s))
+            chunk.meshSections[s].version = version;
+      return;
+   }
+
+   // I lati noti valgono da subito: meshNewChunks non deve richiedere di nuovo la stessa mesh
+   chunk.updateMeshBorderSides(border.sideMask(), sectionMask);
+
+   MeshSnapshot snapshot;
+   snapshot.chunk.pos = chunk.pos;
+   snapshot.chunk.sections = chunk.sections;
+   snapshot.chunk.heightMap = chunk.heightMap;
+   snapshot.chunk.minY = chunk.minY;
+   snapshot.chunk.maxY = chunk.maxY;
+   snapshot.border = std::move(border);
+   snapshot.mode = meshingMode;
+   snapshot.sectionMask = sectionMask;
+   snapshot.version = version;
+   mesher().request(std::move(snapshot));
+}
+
+ChunkMeshPool &World::mesher()
+{
+   if (!meshPool)
+      meshPool = std::make_unique<ChunkMeshPool>();
+   return *meshPool;
+}
+
+void World::integrateMeshes()
+{
+   if (!meshPool)
+      return;
+
+   std::vector<MeshedSections> meshed;
+   meshPool->collect(meshed);
+   for (MeshedSections &result : meshed)
+   {
+      auto it = chunksMap.find(result.pos);
+      if (it == chunksMap.end())
+         continue;
+      Chunk &chunk = it->second;
+      for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+      {
+         SectionMesh &mesh = chunk.meshSections[s];
+         if (!(result.sectionMask & (1u << s)) || result.version < mesh.requestedVersion)
+            continue;
+         mesh.data = std::move(result.sections[s]);
+         mesh.version = result.version;
+         mesh.dirty = true;
+         chunk.meshDirty = true;
+      }
+   }
+}
+
+void World::waitForMeshes()
+{
+   if (!meshPool)
+      return;
+   meshPool->waitIdle();
+   integrateMeshes();
+}
+
+void World::meshNewChunks(const std::vector<Point2D> &added)
+{
+   // Prima tutti i nuovi chunk, così quelli arrivati insieme si vedono a vicenda
+   std::unordered_set<Point2D> addedSet(added.begin(), added.end());
+   for (const Point2D &pos : added)
+      meshChunk(chunksMap.at(pos));
+
+   // Poi, una volta sola, i vicini già presenti il cui bordo verso un nuovo chunk era rimasto scoperto
+   std::unordered_set<Point2D> stale;
+   for (const Point2D &pos : added)
+   {
+      for (int side = 0; side < CHUNK_SIDES; side++)
+      {
+         Point2D neighbourPos(pos.x + SIDE_OFFSETS[side][0], pos.z + SIDE_OFFSETS[side][1]);
+         if (addedSet.count(neighbourPos))
+            continue;
+         auto it = chunksMap.find(neighbourPos);
+         if (it != chunksMap.end() && !(it->second.meshBorderSides & (1 << (side ^ 1))))
+            stale.insert(neighbourPos);
+      }
+   }
+   for (const Point2D &pos : stale)
+      meshChunk(chunksMap.at(pos));
+}
+
+ChunkGenerationPool &World::generator()
+{
+   if (!generationPool)
+      generationPool = std::make_unique<ChunkGenerationPool>(generationSeed);
+   return *generationPool;
+}
+
+void World::generateChunk(const Point2D &pos)
+{
+   generator().request(pos);
+}
+
+void World::integrateGeneratedChunks()
+{
+   if (!generationPool)
+      return;
+
+   std::vector<Chunk> generated;
+   generationPool->collect(generated);
+   std::vector<Point2D> added;
+   for (Chunk &chunk : generated)
+   {
+      // La camera si è spostata mentre il chunk veniva generato: non serve più
+      if (visibleRadius >= 0 &&
+          (std::fabs(chunk.pos.x - visibleCenter.x) > visibleRadius ||
+           std::fabs(chunk.pos.z - visibleCenter.z) > visibleRadius))
+         continue;
+
+      added.push_back(chunk.pos);
+      addGeneratedChunk(chunk);
+   }
+   meshNewChunks(added);
+}
+
+void World::addGeneratedChunk(Chunk &chunk)
+{
+   // Un chunk mai modificato si rigenera identico dal seed: di norma non serve scriverlo
+   if (chunkPersistence == ChunkPersistence::ALL)
+      markChunkDirty(chunk); // Salvato dal thread di scrittura
+   Point2D pos = chunk.pos;
+   chunksMap[pos] = std::move(chunk);
+}
+
+void World::unloadChunk(const Point2D &pos)
+{
+   // I blocchi vengono liberati con il chunk; le risorse sulla GPU appartengono al renderer
+   auto it = chunksMap.find(pos);
+   if (it != chunksMap.end() && onChunkUnload)
+      onChunkUnload(it->second);
+}
+
+void World::generateChunkGrid(int gridSize)
+{
+   ChunkGenerationPool &pool = generator();
+   pool.setFocus(Point2D(0, 0));
+   for (int i = -gridSize; i <= gridSize; ++i)
+   {
+      for (int j = -gridSize; j <= gridSize; ++j)
+      {
+         pool.request(Point2D(i, j));
+      }
+   }
+   pool.waitIdle();
+
+   std::vector<Chunk> generated;
+   pool.collect(generated);
+   std::vector<Point2D> added;
+   for (Chunk &chunk : generated)
+   {
+      added.push_back(chunk.pos);
+      addGeneratedChunk(chunk);
+   }
+   meshNewChunks(added);
+}
+
+bool World::initializeWorld(const std::string &worldName, bool replaceExisting)
+{
+   if (!isValidWorldName(worldName))
+   {
+      std::cerr << "Nome del mondo non valido: '" << worldName << "'" << std::endl;
+      return false;
+   }
+
+   // Un mondo nuovo non eredita regioni, manifest e journal di un mondo con lo stesso nome:
+   // i suoi chunk (e le differenze dal terreno del suo seed) non valgono per il nuovo seed
+   fs::path worldPath = fs::path("worlds") / worldName;
+   if (fs::exists(worldPath) && !replaceExisting)
+   {
+      std::cerr << "Il mondo '" << worldName << "' esiste già." << std::endl;
+      return false;
+   }
+
+   closeWorldStorage();
+   // Il pool rigenera anche i chunk salvati come differenze: va ricreato con il seed del nuovo mondo
+   generationPool.reset();
+   currentWorldName = worldName;
+   if (fs::exists(worldPath))
+   {
+      std::clog << "Il mondo esistente '" << worldName << "' viene sostituito da un mondo nuovo" << std::endl;
+      fs::remove_all(worldPath);
+   }
+   fs::create_directories(worldPath);
+   fs::create_directories(worldPath / "region");
+   openWorldStorage(worldPath);
+
+   // Save initial world info
+   saveWorldInfo();
+   return true;
+}
+
+bool World::isValidWorldName(const std::string &worldName)
+{
+   if (worldName.empty() || worldName == "." || worldName == ".." ||
+       worldName.find_first_of("/\\") != std::string::npos)
+      return false;
+   // Niente radice né unità (ad esempio "C:" su Windows), e un solo componente
+   fs::path name(worldName);
+   return !name.has_root_path() && std::distance(name.begin(), name.end()) == 1;
+}
+
+World::~World()
+{
+   closeWorldStorage();
+}
+
+void World::saveWorldInfo(bool withCamera)
+{
+   if (currentWorldName.empty())
+      return;
+
+   fs::path worldPath = fs::path("worlds") / currentWorldName;
+   std::ofstream worldInfo(worldPath / "world.info");
+   worldInfo << "seed " << generationSeed << "\n";
+   if (withCamera)
+      worldInfo << "camera " << camera.pos.x << " " << camera.pos.y << " " << camera.pos.z << " "
+                << camera.rot.xRot << " " << camera.rot.yRot << "\n";
+   worldInfo.close();
+}
+
+void World::saveChunk(const Point2D &pos, const Chunk &chunk)
+{
+   if (currentWorldName.empty())
+      return;
+
+   // Save chunk data (formato compatto) nel file della sua regione
+   std::vector<char> bytes;
+   encodeForDisk(chunk, bytes, compressChunkData, deltaChunkData);
+   std::lock_guard<std::mutex> lock(regionMutex);
+   if (regionFor(pos).write(pos, bytes.data(), bytes.size()))
+      manifest.add(pos);
+   else
+      std::cerr << "Impossibile salvare il chunk " << pos.x << ", " << pos.z << std::endl;
+}
+
+void World::encodeForDisk(const Chunk &chunk, std::vector<char> &out, bool compress, bool delta) const
+{
+   ChunkCodec::encode(chunk, out, compress);
+   if (!delta || !baselineNoise)
+      return;
+
+   Chunk baseline(chunk.pos);
+   baseline.generate(*baselineNoise);
+   std::vector<char> differences;
+   ChunkCodec::encodeDelta(chunk, baseline, baselineOrigin, differences, compress);
+   if (differences.size() < out.size())
+      out.swap(differences);
+}
+
+void World::markChunkDirty(const Chunk &chunk)
+{
+   if (saveQueue)
+      saveQueue->markDirty(chunk);
+}
+
+void World::flushSaves()
+{
+   if (saveQueue)
+      saveQueue->flush();
+}
+
+ChunkSaveQueue::Stats World::saveStats() const
+{
+   return saveQueue ? saveQueue->stats() : ChunkSaveQueue::Stats();
+}
+
+void World::syncJournal()
+{
+   if (journal)
+      journal->sync();
+}
+
+size_t World::storedChunkCount()
+{
+   std::lock_guard<std::mutex> lock(regionMutex);
+   return manifest.size();
+}
+
+void World::closeWorldStorage()
+{
+   saveWorldInfo(true);
+   // Il distruttore della coda scrive i chunk rimasti e conclude l'ultimo checkpoint del journal
+   saveQueue.reset();
+   journal.reset();
+   baselineNoise.reset();
+   std::lock_guard<std::mutex> lock(regionMutex);
+   // Tutte le scritture sono concluse: l'indice salvato corrisponde alle regioni
+   if (!currentWorldName.empty())
+      manifest.save((fs::path("worlds") / currentWorldName / "chunks.manifest").string());
+   manifest.clear();
+   regionFiles.clear();
+   closedRegionUnsynced = false;
+}
+
+void World::openWorldStorage(const fs::path &worldPath)
+{
+   // Indice dei chunk salvati dal manifest scritto alla chiusura, o ricostruito dalle tabelle delle
+   // regioni se manca. Il file viene eliminato finché il mondo è aperto: dopo un'interruzione non
+   // resta un indice più vecchio delle regioni.
+   fs::path manifestPath = worldPath / "chunks.manifest";
+   {
+      std::lock_guard<std::mutex> lock(regionMutex);
+      if (!manifest.load(manifestPath.string()))
+         manifest.rebuild((worldPath / "region").string());
+   }
+   std::error_code error;
+   fs::remove(manifestPath, error);
+
+   // I mondi salvati un file per chunk vengono convertiti una volta sola nei file di regione
+   importLegacyChunks(worldPath);
+
+   // Serve già al journal: i chunk salvati come differenze vanno rigenerati per essere letti
+   baselineNoise = std::make_unique<PerlinNoise>(generationSeed);
+   baselineOrigin.seed = generationSeed;
+   baselineOrigin.generator = Chunk::GENERATOR_VERSION;
+
+   // Modifiche registrate ma non ancora nelle regioni (il gioco si è interrotto prima di un checkpoint)
+   replayJournal(worldPath / "journal");
+
+   journal = std::make_unique<EditJournal>((worldPath / "journal").string(), journalSyncInterval);
+   ChunkSaveQueue::FlushHooks hooks;
+   hooks.begin = [this]
+   { checkpointActive = journal->beginCheckpoint(); };
+   hooks.end = [this](bool allWritten)
+   {
+      // I segmenti chiusi si possono eliminare solo quando le regioni sono sul disco
+      if (!checkpointActive)
+         return;
+      checkpointActive = false;
+      journal->completeCheckpoint(allWritten && syncRegions());
+   };
+   saveQueue = std::make_unique<ChunkSaveQueue>(
+       [this](const Point2D &pos, const std::vector<char> &bytes)
+       {
+          std::lock_guard<std::mutex> lock(regionMutex);
+          if (regionFor(pos).write(pos, bytes.data(), bytes.size()))
+          {
+             manifest.add(pos);
+             return true;
+          }
+          std::cerr << "Impossibile salvare il chunk " << pos.x << ", " << pos.z << std::endl;
+          return false;
+       },
+       [this, compress = compressChunkData, delta = deltaChunkData](const Chunk &chunk, std::vector<char> &bytes)
+       { encodeForDisk(chunk, bytes, compress, delta); },
+       saveFlushInterval, hooks);
+}
+
+void World::replayJournal(const fs::path &journalPath)
+{
+   std::vector<BlockEdit> edits = EditJournal::readAll(journalPath.string());
+   if (edits.empty())
+   {
+      EditJournal::removeAll(journalPath.string());
+      return;
+   }
+
+   // Le modifiche vengono riapplicate in ordine ai chunk salvati (o rigenerati dal seed se non
+   // erano ancora stati scritti), che tornano poi nelle regioni prima di eliminare il journal
+   std::unordered_map<Point2D, Chunk> touched;
+   int mismatches = 0;
+   for (const BlockEdit &edit : edits)
+   {
+      Point2D chunkPos(std::floor(edit.x / static_cast<float>(CHUNK_SIZE)), std::floor(edit.z / static_cast<float>(CHUNK_SIZE)));
+      auto it = touched.find(chunkPos);
+      if (it == touched.end())
+      {
+         Chunk chunk(chunkPos);
+         if (!loadChunk(chunkPos, chunk))
+            chunk.generate(*baselineNoise);
+         it = touched.emplace(chunkPos, std::move(chunk)).first;
+      }
+
+      int localX = edit.x - static_cast<int>(chunkPos.x) * CHUNK_SIZE;
+      int localZ = edit.z - static_cast<int>(chunkPos.z) * CHUNK_SIZE;
+      BlockType current = it->second.get(localX, edit.y, localZ);
+      if (current != edit.oldType && current != edit.newType)
+         mismatches++;
+      it->second.set(localX, edit.y, localZ, edit.newType);
+   }
+
+   for (const auto &chunkPair : touched)
+      saveChunk(chunkPair.first, chunkPair.second);
+   if (!syncRegions())
+   {
+      std::cerr << "Journal non eliminato: le regioni non sono state sincronizzate" << std::endl;
+      return;
+   }
+   EditJournal::removeAll(journalPath.string());
+
+   std::clog << "Journal: " << edits.size() << " modifiche riapplicate a " << touched.size() << " chunk";
+   if (mismatches > 0)
+      std::clog << " (" << mismatches << " su blocchi diversi dal previsto)";
+   std::clog << std::endl;
+}
+
+bool World::syncRegions()
+{
+   std::lock_guard<std::mutex> lock(regionMutex);
+   bool synced = !closedRegionUnsynced;
+   closedRegionUnsynced = false;
+   for (auto &region : regionFiles)
+      synced = region.second.file->sync() && synced;
+   return synced;
+}
+
+size_t World::openRegionCount()
+{
+   std::lock_guard<std::mutex> lock(regionMutex);
+   return regionFiles.size();
+}
+
+RegionFile &World::regionFor(const Point2D &chunkPos)
+{
+   Point2D regionPos = RegionFile::regionOf(chunkPos);
+   auto it = regionFiles.find(regionPos);
+   if (it == regionFiles.end())
+   {
+      // Troppi file aperti: si chiude quello usato meno di recente, dopo averne reso durevoli
+      // le scritture (altrimenti lo segnala al prossimo checkpoint del journal)
+      if (regionFiles.size() >= std::max<size_t>(1, maxOpenRegions))
+      {
+         auto oldest = std::min_element(regionFiles.begin(), regionFiles.end(), [](const auto &a, const auto &b)
+                                        { return a.second.lastUse < b.second.lastUse; });
+         if (!oldest->second.file->sync())
+            closedRegionUnsynced = true;
+         regionFiles.erase(oldest);
+      }
+      fs::path regionPath = fs::path("worlds") / currentWorldName / "region" / RegionFile::fileName(regionPos);
+      it = regionFiles.emplace(regionPos, OpenRegion{std::make_unique<RegionFile>(regionPath.string(), regionPos)}).first;
+   }
+   it->second.lastUse = ++regionUses;
+   return *it->second.file;
+}
+
+void World::importLegacyChunks(const fs::path &worldPath)
+{
+   fs::path legacyPath = worldPath / "chunks";
+   if (!fs::is_directory(legacyPath))
+      return;
+
+   fs::create_directories(worldPath / "region");
+   for (const auto &entry : fs::directory_iterator(legacyPath))
+   {
+      std::string filename = entry.path().filename().string();
+      int x, z;
+      if (entry.path().extension() != ".dat" || sscanf(filename.c_str(), "chunk_%d_%d.dat", &x, &z) != 2)
+         continue;
+
+      Point2D chunkPos(x, z);
+      {
+         std::lock_guard<std::mutex> lock(regionMutex);
+         if (regionFor(chunkPos).contains(chunkPos))
+            continue;
+      }
+      // Convertito nel formato compatto durante l'importazione
+      std::ifstream chunkFile(entry.path(), std::ios::binary);
+      Chunk chunk(chunkPos);
+      readChunkData(chunkFile, chunk);
+      if (chunkFile)
+         saveChunk(chunkPos, chunk);
+   }
+
+   // La cartella resta come copia di sicurezza, ma non viene più importata
+   std::error_code error;
+   fs::rename(legacyPath, worldPath / "chunks_legacy", error);
+}
+
+void World::writeChunkData(std::ostream &out, const Chunk &chunk)
+{
+   std::vector<int> fileData(CHUNK_VOLUME);
+   std::vector<uint8_t> sectionIds(SECTION_VOLUME);
+   for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
+   {
+      const ChunkSection &section = chunk.sections[s];
+      int yBegin = s * SECTION_HEIGHT;
+      if (section.isUniform())
+      {
+         int blockType = static_cast<int>(section.uniformType());
+         for (int x = 0; x < CHUNK_SIZE; x++)
+            for (int z = 0; z < CHUNK_SIZE; z++)
+               std::fill_n(&fileData[fileBlockIndex(x, yBegin, z)], SECTION_HEIGHT, blockType);
+         continue;
+      }
+
+      section.unpack(sectionIds.data());
+      for (int y = 0; y < SECTION_HEIGHT; y++)
+         for (int z = 0; z < CHUNK_SIZE; z++)
+            for (int x = 0; x < CHUNK_SIZE; x++)
+               fileData[fileBlockIndex(x, yBegin + y, z)] = sectionIds[ChunkSection::blockIndex(x, y, z)];
+   }
+   out.write(reinterpret_cast<const char *>(fileData.data()), fileData.size() * sizeof(int));
+}
+
+void World::readChunkData(std::istream &in, Chunk &chunk)
+{
+   std::vector<int> fileData(CHUNK_VOLUME);
+   in.read(reinterpret_cast<char *>(fileData.data()), fileData.size() * sizeof(int));
+
+   std::vector<uint8_t> ids(CHUNK_VOLUME);
+   for (int y = 0; y < CHUNK_HEIGHT; y++)
+      for (int z = 0; z < CHUNK_SIZE; z++)
+         for (int x = 0; x < CHUNK_SIZE; x++)
+            ids[Chunk::blockIndex(x, y, z)] = static_cast<uint8_t>(fileData[fileBlockIndex(x, y, z)]);
+   chunk.fillFromIds(ids.data());
+   chunk.recomputeBounds();
+}
+
+bool World::loadWorld(const std::string &worldName, int renderDistance)
+{
+   if (!isValidWorldName(worldName))
+   {
+      std::cerr << "Nome del mondo non valido: '" << worldName << "'" << std::endl;
+      return false;
+   }
+   fs::path worldPath = fs::path("worlds") / worldName;
+   if (!fs::exists(worldPath))
+   {
+      std::cerr << "World '" << worldName << "' does not exist." << std::endl;
+      return false;
+   }
+
+   // Load world info (la camera manca nei mondi chiusi prima di salvarla).
+   // Seed e camera restano in variabili locali finché il mondo precedente non è chiuso:
+   // closeWorldStorage() riscrive il suo world.info con i valori correnti.
+   std::ifstream worldInfo(worldPath / "world.info");
+   std::string token;
+   int savedSeed = generationSeed;
+   worldInfo >> token >> savedSeed;
+   Camera savedCamera;
+   bool hasCamera = worldInfo >> token && token == "camera" &&
+                    worldInfo >> savedCamera.pos.x >> savedCamera.pos.y >> savedCamera.pos.z >> savedCamera.rot.xRot >> savedCamera.rot.yRot;
+   worldInfo.close();
+
+   // Il mondo precedente viene chiuso (coda scritta, journal concluso) prima di cambiare nome
+   closeWorldStorage();
+   currentWorldName = worldName;
+   generationSeed = savedSeed;
+   if (hasCamera)
+      camera = savedCamera;
+   else
+      camera.reset();
+   openWorldStorage(worldPath);
+
+   // Il pool usa il seed del mondo: va ricreato con quello appena letto.
+   // Le mesh ancora in preparazione sono del mondo precedente.
+   generationPool.reset();
+   meshPool.reset();
+
+   // Clear existing chunks (l'area visibile verrà ricalcolata da capo)
+   for (auto &chunkPair : chunksMap)
+      unloadChunk(chunkPair.first);
+   chunksMap.clear();
+   pendingLoads.clear();
+   visibleRadius = -1;
+
+   // Prima il chunk della camera (caricato o rigenerato), necessario per sollevare sul terreno
+   // la camera di un mondo senza posizione salvata
+   Point2D cameraChunk = getChunkCoordinates(camera.pos);
+   Chunk chunk(cameraChunk);
+   if (!loadChunk(cameraChunk, chunk))
+      chunk.generate(*baselineNoise);
+   chunksMap[cameraChunk] = std::move(chunk);
+   meshNewChunks({cameraChunk});
+   if (!hasCamera)
+      resetCamera();
+
+   // Poi, senza limite per frame, i chunk salvati dell'area visibile; quelli mai salvati e quelli
+   // salvati come differenze vengono richiesti al pool e il resto del mondo resta su disco
+   int loadCap = maxChunkLoadsPerFrame;
+   maxChunkLoadsPerFrame = std::numeric_limits<int>::max();
+   updateVisibleChunks(camera, renderDistance);
+   maxChunkLoadsPerFrame = loadCap;
+
+   //std::cout << "Sono stati caricati " << chunksMap.size() << " chunks da '" << worldName << "'" << std::endl;
+   return true;
+}
+
+bool World::loadChunk(const Point2D &pos, Chunk &chunk, std::vector<char> *deferredDelta)
+{
+   if (currentWorldName.empty())
+      return false;
+
+   // Una copia in attesa di scrittura è più recente di quella su disco
+   if (saveQueue && saveQueue->readPending(pos, chunk))
+      return true;
+
+   std::vector<char> bytes;
+   {
+      std::lock_guard<std::mutex> lock(regionMutex);
+      if (!manifest.contains(pos) || !regionFor(pos).read(pos, bytes))
+         return false;
+   }
+
+   if (ChunkCodec::isDelta(bytes.data(), bytes.size()))
+   {
+      // Differenze dal chunk mai modificato: lo si rigenera e le si applica, solo se il terreno
+      // di riferimento è quello del seed e del generatore del mondo aperto
+      ChunkCodec::DeltaBaseline origin;
+      if (!ChunkCodec::readDeltaBaseline(bytes.data(), bytes.size(), origin))
+      {
+         std::cerr << "Differenze del chunk " << pos.x << ", " << pos.z << " non valide" << std::endl;
+         return false;
+      }
+      if (origin != baselineOrigin)
+      {
+         std::cerr << "Differenze del chunk " << pos.x << ", " << pos.z << " riferite al seed " << origin.seed
+                   << " (generatore " << origin.generator << "), non al seed " << baselineOrigin.seed
+                   << " (generatore " << baselineOrigin.generator << ") del mondo" << std::endl;
+         return false;
+      }
+      if (deferredDelta)
+      {
+         *deferredDelta = std::move(bytes);
+         return true;
+      }
+      Chunk restored(pos);
+      restored.generate(*baselineNoise);
+      if (ChunkCodec::decodeDelta(bytes.data(), bytes.size(), baselineOrigin, restored))
+      {
+         chunk.sections = std::move(restored.sections);
+         chunk.heightMap = restored.heightMap;
+         chunk.minY = restored.minY;
+         chunk.maxY = restored.maxY;
+         return true;
+      }
+      std::cerr << "Differenze del chunk " << pos.x << ", " << pos.z << " non valide" << std::endl;
+      return false;
+   }
+
+   if (ChunkCodec::isEncoded(bytes.data(), bytes.size()))
+   {
+      if (ChunkCodec::decode(bytes.data(), bytes.size(), chunk))
+         return true;
+      std::cerr << "Dati del chunk " << pos.x << ", " << pos.z << " non validi" << std::endl;
+      return false;
+   }
+
+   // Regioni scritte prima del formato compatto: un int per blocco
+   if (bytes.size() != ChunkCodec::LEGACY_BYTES)
+      return false;
+   MemoryReadBuffer buffer(bytes.data(), bytes.size());
+   std::istream chunkData(&buffer);
+   readChunkData(chunkData, chunk);
+   return true;
+}
+
+void World::placeBlock(const Point3D &pos, BlockType type)
+{
+   // Arrotonda le coordinate della posizione a interi
+   int blockX = static_cast<int>(std::round(pos.x));
+   int blockY = static_cast<int>(std::round(pos.y));
+   int blockZ = static_cast<int>(std::round(pos.z));
+
+   // Calcola le coordinate del chunk usando il floor
+   int chunkX = static_cast<int>(std::floor(blockX / static_cast<float>(CHUNK_SIZE)));
+   int chunkZ = static_cast<int>(std::floor(blockZ / static_cast<float>(CHUNK_SIZE)));
+   Point2D chunkCoords(chunkX, chunkZ);
+
+   auto it = chunksMap.find(chunkCoords);
+   if (it == chunksMap.end())
+   {
+      return;
+   }
+
+   // Calcola le coordinate locali all'interno del chunk.
+   int localX = blockX - chunkX * CHUNK_SIZE;
+   int localZ = blockZ - chunkZ * CHUNK_SIZE;
+   int localY = blockY;
+
+   // Controlla i limiti
+   if (localX < 0 || localX >= CHUNK_SIZE ||
+       localZ < 0 || localZ >= CHUNK_SIZE ||
+       localY < 0 || localY >= CHUNK_HEIGHT)
+   {
+      return;
+   }
+
+   // Aggiorna il blocco nel chunk corrente.
+   BlockType previous = it->second.get(localX, localY, localZ);
+   if (previous == type)
+      return;
+   it->second.set(localX, localY, localZ, type);
+   // Solo la sezione del blocco (e quella confinante se il blocco è sul suo bordo)
+   meshChunk(it->second, Chunk::sectionsTouchedBy(localY));
+
+   // La copia per la coda di scrittura va presa prima di registrare la modifica: un checkpoint che
+   // inizia tra le due trova già il chunk in coda, e il record finisce nel segmento successivo
+   markChunkDirty(it->second);
+   if (journal)
+      journal->append({blockX, blockZ, blockY, previous, type});
+
+   // Aggiorna la mesh dei chunk adiacenti se il blocco tocca il bordo: nel vicino cambia solo
+   // la sezione alla stessa quota.
+   int directions[6][3] = {
+       {-1, 0, 0},
+       {1, 0, 0},
+       {0, 0, -1},
+       {0, 0, 1},
+       {0, -1, 0},
+       {0, 1, 0} // Anche se il cambio verticale potrebbe non influire su facce laterali
+   };
+
+   for (int i = 0; i < 6; i++)
+   {
+      int nx = blockX + directions[i][0];
+      // int ny = blockY + directions[i][1];
+      int nz = blockZ + directions[i][2];
+      int neighborChunkX = static_cast<int>(std::floor(nx / static_cast<float>(CHUNK_SIZE)));
+      int neighborChunkZ = static_cast<int>(std::floor(nz / static_cast<float>(CHUNK_SIZE)));
+      // Se il blocco adiacente appartiene ad un chunk diverso, aggiorna la sua mesh.
+      if (neighborChunkX != chunkX || neighborChunkZ != chunkZ)
+      {
+         Point2D neighborCoords(neighborChunkX, neighborChunkZ);
+         auto neighborIt = chunksMap.find(neighborCoords);
+         if (neighborIt != chunksMap.end())
+         {
+            meshChunk(neighborIt->second, 1u << (localY / SECTION_HEIGHT));
+         }
+      }
+   }
+}
@@ -0,0 +1,274 @@
+// ================================
+// MONDO
+// ================================
+#pragma once
+
+#include <filesystem>
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core.h"
+#include "Chunk.h"
+#include "ChunkCodec.h"
+#include "ChunkGenerationPool.h"
+#include "ChunkManifest.h"
+#include "ChunkMeshPool.h"
+#include "ChunkSaveQueue.h"
+#include "EditJournal.h"
+#include "PerlinNoise.h"
+#include "RegionFile.h"
+
+// Chunk scritti su disco
+enum class ChunkPersistence
+{
+   ALL,     // Anche quelli appena generati, mai modificati
+   MODIFIED // Solo quelli modificati: gli altri vengono rigenerati dal seed quando servono
+};
+
+// Aggiorna la classe World per includere i metodi utili
+class World
+{
+public:
+   Camera camera;
+   std::unordered_map<Point2D, Chunk> chunksMap;
+   int generationSeed;
+   Point3D spawnPoint;
+   std::string currentWorldName; // Add this as a class member
+   // Pool che genera i chunk mancanti fuori dal thread di rendering (creato al primo uso con generationSeed)
+   std::unique_ptr<ChunkGenerationPool> generationPool;
+   // Pool che genera le mesh dei chunk fuori dal thread di rendering (creato al primo uso)
+   std::unique_ptr<ChunkMeshPool> meshPool;
+   // Modalità con cui vengono generate le mesh dei chunk
+   MeshingMode meshingMode = MeshingMode::GREEDY;
+   // Mesh generate sul pool (le sezioni arrivano con integrateMeshes) o subito sul thread principale
+   bool asyncMeshing = true;
+   // Massimo numero di chunk caricati dal disco (e meshati) per ogni chiamata a updateVisibleChunks
+   int maxChunkLoadsPerFrame = 4;
+   // Passaggio LZ dopo la codifica a run dei chunk salvati (si può disattivare per confronto)
+   bool compressChunkData = true;
+   // Quali chunk vengono salvati
+   ChunkPersistence chunkPersistence = ChunkPersistence::MODIFIED;
+   // Un chunk modificato può essere salvato come differenze rispetto al chunk rigenerato dal seed,
+   // quando sono più piccole della codifica completa
+   bool deltaChunkData = true;
+   // Intervallo con cui la coda di salvataggio scrive i chunk modificati
+   std::chrono::milliseconds saveFlushInterval{2000};
+   // Intervallo con cui il journal rende durevoli (un fsync per lotto) le modifiche registrate
+   std::chrono::milliseconds journalSyncInterval{50};
+   // File di regione tenuti aperti (un descrittore ciascuno): oltre, il meno usato di recente
+   // viene sincronizzato e chiuso
+   size_t maxOpenRegions = 64;
+   // Chiamata per ogni chunk appena prima che esca da chunksMap: il renderer libera qui
+   // i buffer sulla GPU, che il motore non gestisce
+   std::function<void(Chunk &)> onChunkUnload;
+
+   // Chiude il mondo aperto, salvando la posizione della camera in world.info
+   ~World();
+
+   // Determina le coordinate del chunk in cui cade un punto nel mondo
+   Point2D getChunkCoordinates(const Point3D &pos) const;
+
+   // Quota del blocco non d'aria più alto alla colonna globale (x, z), letta in O(1) dalla heightmap.
+   // Restituisce -1 se il chunk non è caricato o la colonna è vuota.
+   int surfaceHeightAt(int worldX, int worldZ) const;
+
+   // Riporta la camera alla posizione iniziale, sollevandola sopra il terreno se ci finirebbe dentro
+   void resetCamera();
+
+   // Aggiorna i chunk visibili in base alla camera e alla render distance, da chiamare una volta per frame.
+   // L'area visibile viene ricalcolata solo quando la camera cambia chunk: si scaricano le strisce
+   // che escono e si accodano quelle che entrano. I chunk in coda vengono poi caricati dal disco
+   // (al più maxChunkLoadsPerFrame per chiamata) o richiesti al pool, a spirale dal centro.
+   void updateVisibleChunks(const Camera &camera, int renderDistance);
+
+   // Chunk dell'area visibile non ancora caricati né richiesti al pool
+   size_t pendingLoadCount() const { return pendingLoads.size(); }
+
+   // Vero quando tutti i chunk dell'ultima area visibile sono in chunksMap
+   bool isVisibleAreaLoaded() const;
+
+   // Cambia la modalità di meshing e rigenera le mesh di tutti i chunk caricati
+   void setMeshingMode(MeshingMode mode);
+
+   // Pool di meshing, creato al primo uso
+   ChunkMeshPool &mesher();
+
+   // Copia nei chunk le mesh completate dal pool (chiamata anche da updateVisibleChunks).
+   // Le mesh di chunk non più caricati e quelle superate da una richiesta più recente vengono scartate.
+   void integrateMeshes();
+
+   // Attende le mesh richieste al pool e le copia nei chunk
+   void waitForMeshes();
+
+   // Richieste di meshing non ancora copiate nei chunk
+   size_t pendingMeshCount() const { return meshPool ? meshPool->pendingCount() : 0; }
+
+   // Pool di generazione, creato al primo uso con il seed corrente
+   ChunkGenerationPool &generator();
+
+   // Metodo per generare un singolo chunk: la richiesta viene accodata al pool
+   // e il chunk entra in chunksMap quando integrateGeneratedChunks() lo raccoglie
+   void generateChunk(const Point2D &pos);
+
+   // Raccoglie i chunk completati dal pool, ne genera la mesh e li inserisce in chunksMap.
+   // I chunk finiti fuori dalla render distance nel frattempo vengono scartati.
+   void integrateGeneratedChunks();
+
+   // Avvisa onChunkUnload che il chunk sta per essere rimosso da chunksMap (la rimozione spetta al chiamante)
+   void unloadChunk(const Point2D &pos);
+
+   // Metodo per generare una griglia di chunk attorno all'origine (in parallelo sul pool, attendendo la fine).
+   // All'avvio basta l'anello attorno alla camera: il resto arriva con updateVisibleChunks.
+   void generateChunkGrid(int gridSize);
+
+   // New function prototype:
+   // La modifica viene registrata nel journal e il chunk accodato per il salvataggio
+   void placeBlock(const Point3D &pos, BlockType type);
+   // Crea un mondo nuovo in worlds/<worldName>. Falso (mondo corrente invariato) se il nome non è
+   // valido o se il mondo esiste già: viene sostituito, eliminandone la cartella, solo con replaceExisting.
+   bool initializeWorld(const std::string &worldName, bool replaceExisting = false);
+
+   // Vero se worldName è un solo componente di percorso relativo (niente separatori, radice, "." o ".."),
+   // quindi worlds/<worldName> resta dentro la cartella dei mondi
+   static bool isValidWorldName(const std::string &worldName);
+
+   // Scrive world.info con il seed e, con withCamera, la posizione della camera da cui riprendere
+   void saveWorldInfo(bool withCamera = false);
+
+   // Salva subito i blocchi del chunk, codificati con ChunkCodec, nel file della sua regione (worlds/<nome>/region).
+   // Le modifiche durante il gioco passano invece da markChunkDirty.
+   void saveChunk(const Point2D &pos, const Chunk &chunk);
+
+   // Accoda il salvataggio del chunk modificato: la coda lo scrive su un thread dedicato
+   // allo scadere di saveFlushInterval, una volta sola anche dopo più modifiche
+   void markChunkDirty(const Chunk &chunk);
+
+   // Scrive subito tutti i chunk in attesa di salvataggio
+   void flushSaves();
+
+   // Statistiche della coda di salvataggio (tutte a zero se nessun mondo è aperto)
+   ChunkSaveQueue::Stats saveStats() const;
+
+   // Rende durevoli subito le modifiche registrate nel journal (di norma avviene a lotti)
+   void syncJournal();
+
+   // Chunk del mondo aperto presenti nei file di regione, secondo l'indice in memoria
+   size_t storedChunkCount();
+
+   // File di regione attualmente aperti (al più maxOpenRegions)
+   size_t openRegionCount();
+
+   // Indice di un blocco nel vecchio formato su disco (un int per blocco, ordine x, z, y)
+   static inline int fileBlockIndex(int x, int y, int z)
+   {
+      return (x * CHUNK_SIZE + z) * CHUNK_HEIGHT + y;
+   }
+
+   // Scrive i blocchi del chunk nel vecchio formato grezzo con un'unica scrittura (i salvataggi usano ChunkCodec).
+   // Le sezioni uniformi vengono riempite direttamente senza decodificarle.
+   static void writeChunkData(std::ostream &out, const Chunk &chunk);
+
+   // Legge i blocchi del chunk dal vecchio formato grezzo e li comprime nelle sezioni
+   static void readChunkData(std::istream &in, Chunk &chunk);
+
+   // Add this new method to the World class.
+   // Un mondo salvato nel vecchio formato (un file per chunk in chunks/) viene prima convertito in regioni.
+   // La camera riprende dalla posizione salvata (o dal punto iniziale) e vengono caricati solo i chunk
+   // entro renderDistance da lei: il resto resta su disco e arriva con updateVisibleChunks, così
+   // il tempo di apertura non dipende da quanto è grande il mondo.
+   bool loadWorld(const std::string &worldName, int renderDistance = RENDER_DISTANCE);
+
+   // Carica i blocchi di un chunk dal file della sua regione, nel formato compatto (completo o come
+   // differenze dal chunk rigenerato) o in quello grezzo delle regioni più vecchie (la mesh va generata
+   // dal chiamante). Falso se il chunk non è salvato: va generato, come quelli mai modificati.
+   // I chunk assenti dall'indice dei chunk salvati non toccano il disco.
+   // Con deferredDelta le differenze non vengono applicate sul thread chiamante: i loro dati
+   // finiscono in deferredDelta (chunk invariato) per essere applicati dal pool di generazione.
+   bool loadChunk(const Point2D &pos, Chunk &chunk, std::vector<char> *deferredDelta = nullptr);
+
+   // Strati dei chunk caricati che confinano con il chunk in pos
+   ChunkBorder borderOf(const Point2D &pos) const;
+
+private:
+   // Inserisce il chunk appena creato in chunksMap, accodandone il salvataggio solo con
+   // ChunkPersistence::ALL (la mesh va generata a parte)
+   void addGeneratedChunk(Chunk &chunk);
+
+   // Codifica il chunk per il disco: differenze dal chunk rigenerato se delta e più piccole,
+   // altrimenti la codifica completa (chiamata anche dal thread di scrittura)
+   void encodeForDisk(const Chunk &chunk, std::vector<char> &out, bool compress, bool delta) const;
+
+   // Genera la mesh delle sezioni in sectionMask del chunk tenendo conto dei vicini caricati.
+   // Con asyncMeshing la mesh viene richiesta al pool su una copia del chunk e dei bordi dei vicini.
+   void meshChunk(Chunk &chunk, uint32_t sectionMask = Chunk::ALL_SECTIONS);
+
+   // Genera la mesh dei chunk appena inseriti in chunksMap e rigenera quella dei vicini
+   // già presenti che era stata costruita senza conoscerli
+   void meshNewChunks(const std::vector<Point2D> &added);
+
+   // Sposta l'area visibile: scarica i chunk usciti e accoda quelli entrati, in ordine a spirale
+   void moveVisibleArea(const Point2D &center, int radius);
+
+   // Carica dal disco o richiede al pool i primi chunk della coda, rispettando maxChunkLoadsPerFrame.
+   // I chunk salvati come differenze contano come caricamenti ma vengono ricostruiti dal pool.
+   void loadPendingChunks();
+
+   // File di regione del mondo corrente che contiene il chunk, aperto al primo uso e tenuto in cache
+   // (chiudendo il meno usato di recente oltre maxOpenRegions). Da chiamare con regionMutex.
+   RegionFile &regionFor(const Point2D &chunkPos);
+
+   // Copia nei file di regione i chunk salvati un file ciascuno in <mondo>/chunks e rinomina la cartella
+   void importLegacyChunks(const std::filesystem::path &worldPath);
+
+   // Chiude il mondo corrente: scrive la coda di salvataggio, conclude il journal e chiude le regioni
+   void closeWorldStorage();
+
+   // Prepara il mondo appena aperto: importa il vecchio formato, riapplica il journal rimasto
+   // da un'interruzione e crea journal e coda di salvataggio, collegati dai checkpoint
+   void openWorldStorage(const std::filesystem::path &worldPath);
+
+   // Riapplica ai chunk le modifiche registrate nel journal, le salva nelle regioni ed elimina il journal
+   void replayJournal(const std::filesystem::path &journalPath);
+
+   // Rende durevoli le scritture su tutti i file di regione aperti
+   bool syncRegions();
+
+   // File di regione aperti, per coordinate di regione, con l'ultimo uso per scegliere quale chiudere.
+   // Il thread di scrittura della coda li usa insieme al thread principale: ogni accesso avviene con regionMutex.
+   struct OpenRegion
+   {
+      std::unique_ptr<RegionFile> file;
+      uint64_t lastUse = 0;
+   };
+   std::unordered_map<Point2D, OpenRegion> regionFiles;
+   uint64_t regionUses = 0;
+   // Una regione chiusa senza riuscire a sincronizzarla: il prossimo syncRegions() fallisce
+   bool closedRegionUnsynced = false;
+   std::mutex regionMutex;
+   // Chunk presenti nelle regioni, aggiornato a ogni scrittura (anch'esso con regionMutex)
+   ChunkManifest manifest;
+   // Journal delle modifiche; dichiarato prima della coda, che lo usa nei checkpoint fino alla sua chiusura
+   std::unique_ptr<EditJournal> journal;
+   bool checkpointActive = false; // Usato solo dal thread di scrittura della coda
+   // Rumore con il seed del mondo aperto, per rigenerare i chunk salvati come differenze
+   // (solo lettura: condiviso tra thread principale e thread di scrittura)
+   std::unique_ptr<PerlinNoise> baselineNoise;
+   // Seed e generatore di baselineNoise, registrati nelle differenze e verificati alla lettura
+   ChunkCodec::DeltaBaseline baselineOrigin;
+   // Dichiarata dopo file di regione e journal: viene distrutta (e svuotata su disco) prima di loro
+   std::unique_ptr<ChunkSaveQueue> saveQueue;
+
+   // Centro e raggio dell'ultima area visibile (raggio negativo: nessuna area ancora calcolata)
+   Point2D visibleCenter;
+   int visibleRadius = -1;
+   // Chunk entrati nell'area visibile e non ancora caricati, ordinati a spirale dal centro
+   std::vector<Point2D> pendingLoads;
+   // Versione dell'ultima richiesta di meshing (vedi SectionMesh::version)
+   uint64_t meshVersion = 0;
+};
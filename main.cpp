@@ -18,6 +18,13 @@
 #include <fstream>
 #include <sstream>
 #include <thread>
+#include <cstdint>
+
+#include "engine/Core.h"
+#include "engine/PerlinNoise.h"
+#include "engine/Chunk.h"
+#include "engine/World.h"
+#include "engine/Frustum.h"
 
 namespace fs = std::filesystem;
 
@@ -33,13 +40,17 @@ namespace fs = std::filesystem;
 // ================================
 // COSTANTI GLOBALI
 // ================================
-const int CHUNK_SIZE = 16;
-const int CHUNK_HEIGHT = 256;
-const int RENDER_DISTANCE = 8;
+// Le costanti del mondo (CHUNK_SIZE, CHUNK_HEIGHT, RENDER_DISTANCE, ...) sono in engine/Core.h
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+// Proiezione prospettica di display(), usata anche per il frustum culling dei chunk
+const float FIELD_OF_VIEW = 45.0f;
+const float NEAR_PLANE = 0.1f;
+const float FAR_PLANE = 10000.0f;
+
+// Budget di ogni frame per il caricamento delle mesh sulla GPU: superato uno dei due limiti,
+// i chunk rimanenti (i più lontani dalla camera) aspettano il frame successivo
+const size_t UPLOAD_BYTES_PER_FRAME = 2 * 1024 * 1024;
+const double UPLOAD_MS_PER_FRAME = 2.0;
 
 // Aggiungi una costante che indica il numero di tipi di blocco texturizzati
 const int NUM_BLOCK_TYPES = 8;
@@ -47,178 +58,11 @@ const int NUM_BLOCK_TYPES = 8;
 // Variabile globale per la texture dei blocchi
 GLuint blockTexture = 0;
 
-// Variabili globali per il sistema delle texture
-int atlasWidth = 0;
-int atlasHeight = 0;
-const int textureCellSize = 16;
+// Le dimensioni dell'atlas (atlasWidth, atlasHeight, textureCellSize) sono in engine/Chunk.h
 
 // ================================
 // STRUTTURE E CLASSI
 // ================================
-class PerlinNoise
-{
-private:
-   int seed;
-   std::vector<int> permutation;
-
-   // Funzione per generare una tabella di permutazione pseudocasuale
-   void generatePermutation()
-   {
-      std::mt19937 generator(seed);
-      permutation.resize(512);
-      for (int i = 0; i < 256; ++i)
-      {
-         permutation[i] = i;
-      }
-      std::shuffle(permutation.begin(), permutation.begin() + 256, generator);
-      // Duplica la tabella per evitare controlli di wrapping
-      for (int i = 0; i < 256; i++)
-      {
-         permutation[256 + i] = permutation[i];
-      }
-   }
-
-   // Funzione per interpolare con un polinomio smoothstep
-   float smoothstep(float t) const
-   {
-      return t * t * (3.0f - 2.0f * t);
-   }
-
-   // Funzione per interpolare linearmente tra due valori
-   float lerp(float a, float b, float t) const
-   {
-      return a + t * (b - a);
-   }
-
-   // Funzione per ottenere il gradiente in un punto della griglia
-   float gradient(int hash, float x, float y, float z) const
-   {
-      hash = hash & 15; // Limita hash a 0-15
-      float u = (hash < 8) ? x : y;
-      float v = (hash < 4) ? y : ((hash == 12 || hash == 14) ? x : z);
-      return ((hash & 1) == 0 ? u : -u) + ((hash & 2) == 0 ? v : -v);
-   }
-
-public:
-   PerlinNoise(int seedValue) : seed(seedValue)
-   {
-      generatePermutation();
-   }
-
-   // Funzione principale per calcolare il Perlin Noise
-   float getNoise(float x, float y, float z) const
-   {
-      // Trova la cella della griglia contenente il punto (x, y, z)
-      int X = static_cast<int>(std::floor(x));
-      int Y = static_cast<int>(std::floor(y));
-      int Z = static_cast<int>(std::floor(z));
-
-      // Usa un sistema di coordinate che gestisce correttamente i negativi
-      int XX = X & 255;
-      int YY = Y & 255;
-      int ZZ = Z & 255;
-
-      x -= std::floor(x);
-      y -= std::floor(y);
-      z -= std::floor(z);
-
-      // Interpolazione smoothstep
-      float u = smoothstep(x);
-      float v = smoothstep(y);
-      float w = smoothstep(z);
-
-      // Hash delle coordinate della griglia
-      int A = permutation[XX] + YY;
-      int AA = permutation[A & 255] + ZZ;
-      int AB = permutation[(A + 1) & 255] + ZZ;
-      int B = permutation[(XX + 1) & 255] + YY;
-      int BA = permutation[B & 255] + ZZ;
-      int BB = permutation[(B + 1) & 255] + ZZ;
-
-      // Combina i risultati dei gradienti
-      float res = lerp(
-          lerp(
-              lerp(gradient(permutation[AA], x, y, z), gradient(permutation[BA], x - 1, y, z), u),
-              lerp(gradient(permutation[AB], x, y - 1, z), gradient(permutation[BB], x - 1, y - 1, z), u), v),
-          lerp(
-              lerp(gradient(permutation[AA + 1], x, y, z - 1), gradient(permutation[BA + 1], x - 1, y, z - 1), u),
-              lerp(gradient(permutation[AB + 1], x, y - 1, z - 1), gradient(permutation[BB + 1], x - 1, y - 1, z - 1), u), v),
-          w);
-
-      return res;
-   }
-};
-
-// Classe Punto
-class Point3D
-{
-public:
-   float x, y, z;
-
-   Point3D(float xPos = 0.0f, float yPos = 0.0f, float zPos = 0.0f) : x(xPos), y(yPos), z(zPos) {}
-
-   void normalize()
-   {
-      float length = std::sqrt(x * x + y * y + z * z);
-      if (length > 0.0f)
-      {
-         x /= length;
-         y /= length;
-         z /= length;
-      }
-   }
-
-   // Operatore == per confrontare due Point3D
-   bool operator==(const Point3D &other) const
-   {
-      return (x == other.x && y == other.y && z == other.z);
-   }
-
-   // Operatore != per confrontare due Point3D
-   bool operator!=(const Point3D &other) const
-   {
-      return !(*this == other);
-   }
-
-   // Operatore + per sommare due Point3D
-   Point3D operator+(const Point3D &other) const
-   {
-      return Point3D(x + other.x, y + other.y, z + other.z);
-   }
-
-   // Operatore * per moltiplicare un Point3D per uno scalare
-   Point3D operator*(float scalar) const
-   {
-      return Point3D(x * scalar, y * scalar, z * scalar);
-   }
-
-   // Operatore * per moltiplicare uno scalare per un Point3D
-   friend Point3D operator*(float scalar, const Point3D &point)
-   {
-      return Point3D(point.x * scalar, point.y * scalar, point.z * scalar);
-   }
-};
-
-class Point2D
-{
-public:
-   float x, z;
-   Point2D(float xPos = 0.0f, float zPos = 0.0f) : x(xPos), z(zPos) {}
-
-   bool operator==(const Point2D &other) const
-   {
-      return (x == other.x && z == other.z);
-   }
-};
-
-// Classe Inclinazione
-class Rotation
-{
-public:
-   float xRot, yRot, zRot;
-   Rotation(float initialXRot = 0.0f, float initialYRot = 0.0f, float initialZRot = 0.0f) : xRot(initialXRot), yRot(initialYRot), zRot(initialZRot) {}
-};
-
 // Classe Colore
 class Color
 {
@@ -234,749 +78,399 @@ public:
    }
 };
 
-// Classe Camera
-class Camera
+// Pool di vertex buffer riciclati, raggruppati per classe di dimensione (potenze di due).
+// Un buffer restituito torna nella lista libera della sua classe e viene riusato con
+// glBufferSubData, senza glGenBuffers né una nuova allocazione con glBufferData.
+class BufferPool
 {
 public:
-   Point3D pos;
-   Rotation rot;
+   static const size_t MIN_CLASS_BYTES = 4 * 1024;
+   static const size_t MAX_FREE_BYTES = 32 * 1024 * 1024; // Oltre questa soglia i buffer liberi vengono cancellati
 
-   Camera(Point3D initialPos = Point3D(0.0f, 0.0f, 0.0f), Rotation initialRot = Rotation(0.0f, 0.0f, 0.0f))
-       : pos(initialPos), rot(initialRot) {}
-
-   void reset()
+   // Classe di dimensione per bytes: la più piccola potenza di due che li contiene
+   static size_t sizeClass(size_t bytes)
    {
-      pos = Point3D(0, 125, 0);
-      rot = Rotation(-30.0f, 45.0f, 0.0f);
-      glutPostRedisplay();
+      size_t capacity = MIN_CLASS_BYTES;
+      while (capacity < bytes)
+         capacity *= 2;
+      return capacity;
    }
 
-   bool isFaceVisible(const Point3D &blockPos, const Point3D &faceNormalVect) const
+   // Restituisce un buffer da capacity byte (una classe di dimensione), riciclato se possibile
+   GLuint acquire(size_t capacity)
    {
-      Point3D directionVect(blockPos.x - pos.x, blockPos.y - pos.y, blockPos.z - pos.z);
-      directionVect.normalize();
-      float dotProduct = directionVect.x * faceNormalVect.x + directionVect.y * faceNormalVect.y + directionVect.z * faceNormalVect.z;
-      return dotProduct < 0.0f;
-   }
-};
+      std::vector<GLuint> &freeList = freeBuffers[capacity];
+      if (!freeList.empty())
+      {
+         GLuint buffer = freeList.back();
+         freeList.pop_back();
+         freeCount--;
+         freeBytes -= capacity;
+         return buffer;
+      }
 
-// Dichiarazione anticipata della classe Chunk
-class Chunk;
+      GLuint buffer = 0;
+      glGenBuffers(1, &buffer);
+      glBindBuffer(GL_ARRAY_BUFFER, buffer);
+      glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STATIC_DRAW);
+      glBindBuffer(GL_ARRAY_BUFFER, 0);
+      liveCount++;
+      liveBytes += capacity;
+      return buffer;
+   }
 
-// Enumerazione globale per i tipi di blocco
-enum class BlockType
-{
-   TEST,        // 00
-   AIR,         // 01
-   GRASS,       // 02
-   DIRT,        // 03
-   STONE,       // 04
-   SAND,        // 05
-   WATER,       // 06
-   BEDROCK,     // 07
-   WOOD,        // 08
-   LEAVES,      // 09
-   PLANKS,      // 10
-   COBBLESTONE, // 11
-   BRICKS,      // 12
-
-   BLOCK_COUNT
+   // Rimette il buffer nella lista libera della sua classe, o lo cancella se il pool è pieno
+   void release(GLuint buffer, size_t capacity)
+   {
+      if (buffer == 0)
+         return;
+      if (freeBytes + capacity > MAX_FREE_BYTES)
+      {
+         glDeleteBuffers(1, &buffer);
+         liveCount--;
+         liveBytes -= capacity;
+         return;
+      }
+      freeBuffers[capacity].push_back(buffer);
+      freeCount++;
+      freeBytes += capacity;
+   }
 
-};
+   // Buffer esistenti sulla GPU (in uso e liberi) e loro dimensione totale
+   size_t liveBufferCount() const { return liveCount; }
+   size_t liveBufferBytes() const { return liveBytes; }
+   // Di cui in attesa di essere riusati
+   size_t freeBufferCount() const { return freeCount; }
+   size_t freeBufferBytes() const { return freeBytes; }
 
-// Classe Blocco
-class Block
-{
-public:
-   BlockType type;
-   Point3D pos;
-   Block() : type(BlockType::AIR), pos(0, 0, 0) {}
-   Block(BlockType t, Point3D p) : type(t), pos(p) {}
+private:
+   std::unordered_map<size_t, std::vector<GLuint>> freeBuffers; // Classe di dimensione -> buffer liberi
+   size_t liveCount = 0;
+   size_t liveBytes = 0;
+   size_t freeCount = 0;
+   size_t freeBytes = 0;
 };
 
-// Classe Chunk
-class Chunk
+// Classe che carica le mesh dei chunk sulla GPU e le disegna.
+// Il motore (engine/) genera le mesh solo sulla CPU; qui avvengono tutte le chiamate OpenGL.
+class ChunkRenderer
 {
 public:
-   Point2D pos; // Coordinate del chunk (in termini di chunk, non di blocco)
-   // Vettore 3D di blocchi: indici [0, CHUNK_SIZE) per x e z, [0, CHUNK_HEIGHT) per y
-   std::vector<std::vector<std::vector<Block>>> blocks;
-   // Mesh generata: lista piatta di vertici (ogni 3 valori rappresentano x,y,z)
-   std::vector<float> meshVertices;
-   // All'interno della classe Chunk, aggiungi il membro per le coordinate texture:
-   std::vector<float> meshTexCoords;
-
-   // Aggiungi i buffer OpenGL
-   GLuint vao = 0;
-   GLuint vbo = 0;
-
-   // Costruttore di default
-   Chunk() : pos(0, 0)
-   {
-      blocks.resize(CHUNK_SIZE, std::vector<std::vector<Block>>(CHUNK_SIZE, std::vector<Block>(CHUNK_HEIGHT, Block())));
-   }
-
-   // Costruttore che riceve le coordinate del chunk
-   Chunk(Point2D p) : pos(p)
+   // Compila lo shader dei chunk (solo funzionalità del core profile): decodifica i vertici impacchettati
+   // (vedi MESH_VERTEX_WORDS) e ripete la texture del blocco dentro la sua cella dell'atlas, necessario
+   // per le facce unite dal mesher greedy (GL_REPEAT ripeterebbe l'intero atlas)
+   void init()
    {
-      blocks.resize(CHUNK_SIZE, std::vector<std::vector<Block>>(CHUNK_SIZE, std::vector<Block>(CHUNK_HEIGHT, Block())));
-   }
-
-   
-   
-   // Funzione per generare il terreno del chunk
-   void generate(const PerlinNoise &noise)
-   {
-      // Parametri esistenti
-      float baseFrequency = 0.01f;
-      int baseHeight = 128;
-      int amplitude = 200;
-      int octaves = 5;
-      float persistence = 0.5f;
-      float biomeFrequency = 0.001f;
-      const int WATER_LEVEL = 110;
-      const int BEACH_RANGE = 2; // Range di altezza per la spiaggia sopra il livello dell'acqua
-
-      // Nuovo parametro per il rumore della sabbia
-      float sandNoiseFrequency = 0.05f; // Frequenza più alta per variazioni più piccole
-
-      for (int x = 0; x < CHUNK_SIZE; x++)
+      const char *vertexSource =
+          "#version 330 core\n"
+          "layout(location = 0) in uvec2 packedVertex;\n"
+          "uniform mat4 viewProjection;\n"
+          "uniform vec3 chunkOrigin;\n"
+          "uniform vec2 tileSize;\n"
+          "out vec4 tileCoord;\n"
+          "void main()\n"
+          "{\n"
+          "   uint corner = packedVertex.x;\n"
+          "   vec3 local = vec3(float(corner & 31u), float((corner >> 10) & 511u), float((corner >> 5) & 31u));\n"
+          "   gl_Position = viewProjection * vec4(chunkOrigin + (local - 0.5), 1.0);\n"
+          "   vec2 repeat = vec2(float(packedVertex.y & 511u), float((packedVertex.y >> 9) & 511u));\n"
+          "   tileCoord = vec4(repeat, vec2(float((corner >> 19) & 7u), float(corner >> 22)) * tileSize);\n"
+          "}\n";
+      const char *fragmentSource =
+          "#version 330 core\n"
+          "uniform sampler2D atlas;\n"
+          "uniform vec2 tileSize;\n"
+          "in vec4 tileCoord;\n"
+          "out vec4 fragColor;\n"
+          "void main()\n"
+          "{\n"
+          "   vec2 uv = tileCoord.zw + fract(tileCoord.xy) * tileSize;\n"
+          "   fragColor = texture(atlas, uv);\n"
+          "}\n";
+
+      program = glCreateProgram();
+      GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource);
+      GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource);
+      glAttachShader(program, vertexShader);
+      glAttachShader(program, fragmentShader);
+      glLinkProgram(program);
+      glDeleteShader(vertexShader);
+      glDeleteShader(fragmentShader);
+
+      GLint linked = GL_FALSE;
+      glGetProgramiv(program, GL_LINK_STATUS, &linked);
+      if (linked != GL_TRUE)
       {
-         for (int z = 0; z < CHUNK_SIZE; z++)
-         {
-            int globalX = static_cast<int>(pos.x * CHUNK_SIZE) + x;
-            int globalZ = static_cast<int>(pos.z * CHUNK_SIZE) + z;
-
-            float biomeValue = noise.getNoise(globalX * biomeFrequency, 0.0f, globalZ * biomeFrequency);
-            biomeValue = (biomeValue + 1.0f) / 2.0f;
-
-            int localBaseHeight = static_cast<int>(baseHeight * (0.7f + 0.3f * biomeValue));
-            int localAmplitude = static_cast<int>(amplitude * (0.1f + 0.9f * biomeValue));
-
-            float totalNoise = 0.0f;
-            float maxAmplitude = 0.0f;
-            float frequency = baseFrequency;
-            float amplitudeLayer = 1.0f;
-
-            for (int i = 0; i < octaves; ++i)
-            {
-               totalNoise += noise.getNoise(globalX * frequency, 0.0f, globalZ * frequency) * amplitudeLayer;
-               maxAmplitude += amplitudeLayer;
-               amplitudeLayer *= persistence;
-               frequency *= 2.0f;
-            }
-
-            totalNoise /= maxAmplitude;
-            int surfaceHeight = localBaseHeight + static_cast<int>(totalNoise * localAmplitude);
-
-            if (surfaceHeight < 5)
-               surfaceHeight = 5;
-            if (surfaceHeight >= CHUNK_HEIGHT)
-               surfaceHeight = CHUNK_HEIGHT - 1;
-
-            // Calcola il rumore per la distribuzione della sabbia
-            float sandNoise = noise.getNoise(globalX * sandNoiseFrequency, 0.0f, globalZ * sandNoiseFrequency);
-            sandNoise = (sandNoise + 1.0f) / 2.0f; // Normalizza a [0,1]
-
-            for (int y = 0; y < CHUNK_HEIGHT; y++)
-            {
-               if (y > surfaceHeight)
-               {
-                  // Se siamo sopra il terreno ma sotto il livello dell'acqua, metti acqua
-                  if (y <= WATER_LEVEL)
-                  {
-                     blocks[x][z][y] = Block(BlockType::WATER, Point3D(globalX, y, globalZ));
-                  }
-                  else
-                  {
-                     blocks[x][z][y] = Block(BlockType::AIR, Point3D(globalX, y, globalZ));
-                  }
-               }
-               else if (y == surfaceHeight)
-               {
-                  // Se siamo al livello della superficie
-                  if (y <= WATER_LEVEL + BEACH_RANGE && y >= WATER_LEVEL - BEACH_RANGE)
-                  {
-                     // Usa il sandNoise per decidere se mettere sabbia o erba
-                     if (sandNoise > 0.4f) // Regola questa soglia per più o meno sabbia
-                     {
-                        blocks[x][z][y] = Block(BlockType::SAND, Point3D(globalX, y, globalZ));
-                     }
-                     else
-                     {
-                        // Se siamo sotto il livello dell'acqua, mettiamo terra invece che erba
-                        if (y < WATER_LEVEL)
-                        {
-                           blocks[x][z][y] = Block(BlockType::DIRT, Point3D(globalX, y, globalZ));
-                        }
-                        else
-                        {
-                           blocks[x][z][y] = Block(BlockType::GRASS, Point3D(globalX, y, globalZ));
-                        }
-                     }
-                  }
-                  else if (y < WATER_LEVEL)
-                  {
-                     // Sotto il livello dell'acqua, usa sempre sabbia
-                     blocks[x][z][y] = Block(BlockType::SAND, Point3D(globalX, y, globalZ));
-                  }
-                  else
-                  {
-                     blocks[x][z][y] = Block(BlockType::GRASS, Point3D(globalX, y, globalZ));
-                  }
-               }
-               else if (y >= surfaceHeight - 3)
-               {
-                  // Anche per gli strati sotto la superficie, usa il noise per decidere
-                  if (surfaceHeight <= WATER_LEVEL + BEACH_RANGE && sandNoise > 0.4f)
-                  {
-                     blocks[x][z][y] = Block(BlockType::SAND, Point3D(globalX, y, globalZ));
-                  }
-                  else
-                  {
-                     blocks[x][z][y] = Block(BlockType::DIRT, Point3D(globalX, y, globalZ));
-                  }
-               }
-               else if (y < 5)
-               {
-                  blocks[x][z][y] = Block(BlockType::BEDROCK, Point3D(globalX, y, globalZ));
-               }
-               else
-               {
-                  blocks[x][z][y] = Block(BlockType::STONE, Point3D(globalX, y, globalZ));
-               }
-            }
-         }
+         char log[1024];
+         glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+         std::cout << "Errore nel collegamento dello shader dei chunk: " << log << std::endl;
+         exit(EXIT_FAILURE);
       }
-   }
 
-   // Funzione helper per aggiungere un quadrilatero (quattro vertici) alla mesh.
-   void addQuadTextured(
-       float x1, float y1, float z1, float u1, float v1,
-       float x2, float y2, float z2, float u2, float v2,
-       float x3, float y3, float z3, float u3, float v3,
-       float x4, float y4, float z4, float u4, float v4)
-   {
-      // Primo vertice
-      meshVertices.push_back(x1);
-      meshVertices.push_back(y1);
-      meshVertices.push_back(z1);
-      meshTexCoords.push_back(u1);
-      meshTexCoords.push_back(v1);
-      // Secondo vertice
-      meshVertices.push_back(x2);
-      meshVertices.push_back(y2);
-      meshVertices.push_back(z2);
-      meshTexCoords.push_back(u2);
-      meshTexCoords.push_back(v2);
-      // Terzo vertice
-      meshVertices.push_back(x3);
-      meshVertices.push_back(y3);
-      meshVertices.push_back(z3);
-      meshTexCoords.push_back(u3);
-      meshTexCoords.push_back(v3);
-      // Quarto vertice
-      meshVertices.push_back(x4);
-      meshVertices.push_back(y4);
-      meshVertices.push_back(z4);
-      meshTexCoords.push_back(u4);
-      meshTexCoords.push_back(v4);
+      atlasLocation = glGetUniformLocation(program, "atlas");
+      tileSizeLocation = glGetUniformLocation(program, "tileSize");
+      chunkOriginLocation = glGetUniformLocation(program, "chunkOrigin");
+      viewProjectionLocation = glGetUniformLocation(program, "viewProjection");
+
+      reserveQuadIndices(INITIAL_QUAD_INDICES);
    }
 
-   // Modifica il metodo generateMesh() della classe Chunk per escludere le facce adiacenti
-   void generateMesh()
+   // Carica sulla GPU le mesh delle sezioni rigenerate, poi libera le loro copie sulla CPU;
+   // restituisce i byte di vertici caricati.
+   // Ogni sezione ha il suo intervallo nel vertex buffer del chunk, con un margine per crescere:
+   // se la nuova mesh ci sta viene riscritto solo quell'intervallo, altrimenti il buffer viene
+   // ridisposto copiando le sezioni invariate direttamente sulla GPU.
+   size_t upload(Chunk &chunk)
    {
-      meshVertices.clear();
-      meshTexCoords.clear();
+      if (!chunk.meshDirty)
+         return 0;
 
-      auto faceVisible = [this](int x, int z, int y, int dx, int dz, int dy) -> bool
+      bool fits = chunk.vbo != 0;
+      size_t totalVertices = 0;
+      for (const SectionMesh &mesh : chunk.meshSections)
       {
-         int nx = x + dx, nz = z + dz, ny = y + dy;
-         if (nx < 0 || nx >= CHUNK_SIZE || nz < 0 || nz >= CHUNK_SIZE || ny < 0 || ny >= CHUNK_HEIGHT)
-            return true;
-         return blocks[nx][nz][ny].type == BlockType::AIR;
-      };
-
-      // Calcola le dimensioni di una singola cella dell'atlas
-      float tileU = float(textureCellSize) / float(atlasWidth);
-      float tileV = float(textureCellSize) / float(atlasHeight);
+         size_t vertices = mesh.dirty ? mesh.vertexCount() : mesh.gpuQuadCount * MESH_QUAD_VERTICES;
+         fits = fits && (!mesh.dirty || vertices <= mesh.gpuCapacity);
+         totalVertices += vertices;
+      }
 
-      for (int x = 0; x < CHUNK_SIZE; x++)
+      // Mesh vuota: il buffer torna al pool
+      if (totalVertices == 0)
       {
-         for (int z = 0; z < CHUNK_SIZE; z++)
+         release(chunk);
+         for (SectionMesh &mesh : chunk.meshSections)
          {
-            for (int y = 0; y < CHUNK_HEIGHT; y++)
-            {
-               Block &block = blocks[x][z][y];
-               if (block.type == BlockType::AIR)
-                  continue;
-
-               // Determina la riga dell'atlas in base al BlockType (stesso ordine dell'enumerazione)
-               int typeRow = static_cast<int>(block.type);
-
-               float bx = block.pos.x;
-               float by = block.pos.y;
-               float bz = block.pos.z;
-               float half = 0.5f;
-
-               // Front face (+z) : colonna 0
-               if (faceVisible(x, z, y, 0, 1, 0))
-               {
-                  float uOffset = 0 * tileU;
-                  float vOffset = typeRow * tileV;
-                  addQuadTextured(
-                      bx - half, by - half, bz + half, uOffset, vOffset + tileV,
-                      bx + half, by - half, bz + half, uOffset + tileU, vOffset + tileV,
-                      bx + half, by + half, bz + half, uOffset + tileU, vOffset,
-                      bx - half, by + half, bz + half, uOffset, vOffset);
-               }
-               // Back face (-z) : colonna 1
-               if (faceVisible(x, z, y, 0, -1, 0))
-               {
-                  float uOffset = 1 * tileU;
-                  float vOffset = typeRow * tileV;
-                  addQuadTextured(
-                      bx + half, by - half, bz - half, uOffset, vOffset + tileV,
-                      bx - half, by - half, bz - half, uOffset + tileU, vOffset + tileV,
-                      bx - half, by + half, bz - half, uOffset + tileU, vOffset,
-                      bx + half, by + half, bz - half, uOffset, vOffset);
-               }
-               // Left face (-x) : colonna 2
-               if (faceVisible(x, z, y, -1, 0, 0))
-               {
-                  float uOffset = 2 * tileU;
-                  float vOffset = typeRow * tileV;
-                  addQuadTextured(
-                      bx - half, by - half, bz - half, uOffset, vOffset + tileV,
-                      bx - half, by - half, bz + half, uOffset + tileU, vOffset + tileV,
-                      bx - half, by + half, bz + half, uOffset + tileU, vOffset,
-                      bx - half, by + half, bz - half, uOffset, vOffset);
-               }
-               // Right face (+x) : colonna 3
-               if (faceVisible(x, z, y, 1, 0, 0))
-               {
-                  float uOffset = 3 * tileU;
-                  float vOffset = typeRow * tileV;
-                  addQuadTextured(
-                      bx + half, by - half, bz + half, uOffset, vOffset + tileV,
-                      bx + half, by - half, bz - half, uOffset + tileU, vOffset + tileV,
-                      bx + half, by + half, bz - half, uOffset + tileU, vOffset,
-                      bx + half, by + half, bz + half, uOffset, vOffset);
-               }
-               // Top face (+y) : colonna 4
-               if (faceVisible(x, z, y, 0, 0, 1))
-               {
-                  float uOffset = 4 * tileU;
-                  float vOffset = typeRow * tileV;
-                  addQuadTextured(
-                      bx - half, by + half, bz + half, uOffset, vOffset,
-                      bx + half, by + half, bz + half, uOffset + tileU, vOffset,
-                      bx + half, by + half, bz - half, uOffset + tileU, vOffset + tileV,
-                      bx - half, by + half, bz - half, uOffset, vOffset + tileV);
-               }
-               // Bottom face (-y) : colonna 5
-               if (faceVisible(x, z, y, 0, 0, -1))
-               {
-                  float uOffset = 5 * tileU;
-                  float vOffset = typeRow * tileV;
-                  addQuadTextured(
-                      bx - half, by - half, bz - half, uOffset, vOffset,
-                      bx + half, by - half, bz - half, uOffset + tileU, vOffset,
-                      bx + half, by - half, bz + half, uOffset + tileU, vOffset + tileV,
-                      bx - half, by - half, bz + half, uOffset, vOffset + tileV);
-               }
-            }
+            std::vector<uint32_t>().swap(mesh.data);
+            mesh.dirty = false;
          }
+         chunk.meshDirty = false;
+         return 0;
       }
 
-      // Ora prepara i dati interlacciati (x,y,z,u,v)
-      std::vector<float> interleaved;
-      size_t numVertices = meshVertices.size() / 3;
-      for (size_t i = 0; i < numVertices; i++)
+      if (chunk.vao == 0)
       {
-         interleaved.push_back(meshVertices[i * 3 + 0]);
-         interleaved.push_back(meshVertices[i * 3 + 1]);
-         interleaved.push_back(meshVertices[i * 3 + 2]);
-         interleaved.push_back(meshTexCoords[i * 2 + 0]);
-         interleaved.push_back(meshTexCoords[i * 2 + 1]);
+         glGenVertexArrays(1, &chunk.vao);
       }
+      glBindVertexArray(chunk.vao);
 
-      // Genera/aggiorna VAO e VBO
-      if (vao == 0)
-      {
-         glGenVertexArrays(1, &vao);
-      }
-      glBindVertexArray(vao);
+      if (fits)
+         glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+      else
+         relayout(chunk);
 
-      if (vbo == 0)
+      // Gli indici dei triangoli vengono dall'index buffer condiviso, registrato nel VAO
+      size_t uploadedBytes = 0;
+      for (SectionMesh &mesh : chunk.meshSections)
       {
-         glGenBuffers(1, &vbo);
+         if (!mesh.dirty)
+            continue;
+         uploadedBytes += mesh.data.size() * sizeof(uint32_t);
+         glBufferSubData(GL_ARRAY_BUFFER, mesh.gpuFirstVertex * MESH_VERTEX_BYTES,
+                         mesh.data.size() * sizeof(uint32_t), mesh.data.data());
+         mesh.gpuQuadCount = mesh.vertexCount() / MESH_QUAD_VERTICES;
+         reserveQuadIndices(mesh.gpuQuadCount);
+
+         // Una volta sulla GPU la copia CPU non serve più
+         std::vector<uint32_t>().swap(mesh.data);
+         mesh.dirty = false;
       }
-      glBindBuffer(GL_ARRAY_BUFFER, vbo);
-      glBufferData(GL_ARRAY_BUFFER, interleaved.size() * sizeof(float), interleaved.data(), GL_STATIC_DRAW);
-
-      // Abilita e definisci l'attributo per la posizione (location 0)
-      glEnableVertexAttribArray(0);
-      glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
-      // Abilita e definisci l'attributo per le coordinate texture (location 1)
-      glEnableVertexAttribArray(1);
-      glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)(3 * sizeof(float)));
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
 
       // Unbind
       glBindBuffer(GL_ARRAY_BUFFER, 0);
       glBindVertexArray(0);
+      chunk.meshDirty = false;
+      return uploadedBytes;
    }
 
-   // Modifica il metodo drawTextured() della classe Chunk per utilizzare anche le coordinate texture:
-   void drawTextured() const
+   // Libera le risorse GPU del chunk: il VAO viene cancellato, il VBO torna al pool
+   void release(Chunk &chunk)
    {
-      if (vao == 0)
-         return; // Nessun dato caricato
-
-      glBindTexture(GL_TEXTURE_2D, blockTexture);
-      glBindVertexArray(vao);
-      // Considerando che ogni quadrilatero è formato da 4 vertici,
-      // il numero totale di vertici è:
-      int totalVertices = static_cast<int>(meshVertices.size() / 3);
-
-      glBindVertexArray(0); // Disabilita momentaneamente il VAO
-
-      glEnableClientState(GL_VERTEX_ARRAY);
-      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
-      glBindBuffer(GL_ARRAY_BUFFER, vbo);
-      glVertexPointer(3, GL_FLOAT, 5 * sizeof(float), (void *)0);
-      glTexCoordPointer(2, GL_FLOAT, 5 * sizeof(float), (void *)(3 * sizeof(float)));
-
-      glDrawArrays(GL_QUADS, 0, totalVertices);
-
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-      glDisableClientState(GL_VERTEX_ARRAY);
-   }
-};
-
-namespace std
-{
-   template <>
-   struct hash<Point2D>
-   {
-      size_t operator()(const Point2D &p) const
-      {
-         // Combinazione hash delle coordinate x e z
-         return hash<float>()(p.x) ^ (hash<float>()(p.z) << 1);
-      }
-   };
-}
-
-// Aggiorna la classe World per includere i metodi utili
-class World
-{
-public:
-   Camera camera;
-   std::unordered_map<Point2D, Chunk> chunksMap;
-   int generationSeed;
-   Point3D spawnPoint;
-   std::string currentWorldName; // Add this as a class member
-
-   // Determina le coordinate del chunk in cui cade un punto nel mondo
-   Point2D getChunkCoordinates(const Point3D &pos) const
-   {
-      return Point2D(std::floor(pos.x / CHUNK_SIZE), std::floor(pos.z / CHUNK_SIZE));
-   }
-
-   // Stub per aggiornare i chunk visibili in base alla camera e alla render distance.
-   // Puoi estendere questa funzione per generare nuovi chunk man mano che la camera si muove.
-   void updateVisibleChunks(const Camera &camera, int renderDistance)
-   {
-      Point2D currentChunkCoords = getChunkCoordinates(camera.pos);
-      std::unordered_set<Point2D> newChunkCoords;
-
-      for (int dx = -renderDistance; dx <= renderDistance; ++dx)
+      if (chunk.vao != 0)
       {
-         for (int dz = -renderDistance; dz <= renderDistance; ++dz)
-         {
-            Point2D chunkCoords(currentChunkCoords.x + dx, currentChunkCoords.z + dz);
-            newChunkCoords.insert(chunkCoords);
-
-            if (chunksMap.find(chunkCoords) == chunksMap.end())
-            {
-               Chunk chunk(chunkCoords);
-               if (loadChunk(chunkCoords, chunk))
-               {
-                  chunksMap[chunkCoords] = chunk;
-               }
-               else
-               {
-                  generateChunk(chunkCoords);                  
-               }
-            }
-         }
+         glDeleteVertexArrays(1, &chunk.vao);
+         chunk.vao = 0;
       }
-
-      // Rimuovi i chunk che non sono più necessari
-      for (auto it = chunksMap.begin(); it != chunksMap.end();)
+      buffers.release(chunk.vbo, chunk.vboCapacity);
+      chunk.vbo = 0;
+      chunk.vboCapacity = 0;
+      for (SectionMesh &mesh : chunk.meshSections)
       {
-         if (newChunkCoords.find(it->first) == newChunkCoords.end())
-         {
-            unloadChunk(it->first);
-            it = chunksMap.erase(it);
-         }
-         else
-         {
-            ++it;
-         }
+         mesh.gpuFirstVertex = 0;
+         mesh.gpuCapacity = 0;
+         mesh.gpuQuadCount = 0;
       }
    }
 
-   // Metodo per generare un singolo chunk
-   void generateChunk(const Point2D &pos)
-   {
-      PerlinNoise noise(generationSeed);
-      Chunk chunk(pos);
-      chunk.generate(noise);
-      chunk.generateMesh();
-      chunksMap[pos] = chunk;
-      saveChunk(pos, chunk);
-   }
-
-   void unloadChunk(const Point2D &pos)
-   {
-      // Dealloca la memoria del chunk se necessario
-
+   // Pool dei vertex buffer (per le statistiche sull'uso della memoria GPU)
+   const BufferPool &bufferPool() const { return buffers; }
 
-      // In questo caso, non c'è nulla di specifico da fare, ma puoi aggiungere logica qui se necessario
-   }
+   // Byte dell'index buffer condiviso dai chunk
+   size_t quadIndexBytes() const { return quadIndexCapacity * MESH_QUAD_INDICES * sizeof(uint32_t); }
 
-   // Metodo per generare una griglia di chunk
-   void generateChunkGrid(int gridSize, const PerlinNoise &noise)
+   // Prepara il disegno dei chunk del frame: programma, texture e uniform comuni una volta sola.
+   // La matrice vista-proiezione viene letta dalle pile della pipeline fissa (gluPerspective, gluLookAt).
+   void begin() const
    {
-      for (int i = -gridSize; i <= gridSize; ++i)
-      {
-         for (int j = -gridSize; j <= gridSize; ++j)
-         {
-            Point2D chunkPos(i, j);
-            Chunk chunk(chunkPos);
-            chunk.generate(noise);
-            chunk.generateMesh();
-            chunksMap[chunkPos] = chunk;
-            saveChunk(chunkPos, chunk); // Save the chunk immediately after generation
-         }
-      }
+      GLfloat projection[16], modelView[16], viewProjection[16];
+      glGetFloatv(GL_PROJECTION_MATRIX, projection);
+      glGetFloatv(GL_MODELVIEW_MATRIX, modelView);
+      // Matrici per colonne: viewProjection = projection * modelView
+      for (int column = 0; column < 4; column++)
+         for (int row = 0; row < 4; row++)
+            viewProjection[column * 4 + row] = projection[row] * modelView[column * 4] +
+                                               projection[4 + row] * modelView[column * 4 + 1] +
+                                               projection[8 + row] * modelView[column * 4 + 2] +
+                                               projection[12 + row] * modelView[column * 4 + 3];
+
+      glUseProgram(program);
+      glUniformMatrix4fv(viewProjectionLocation, 1, GL_FALSE, viewProjection);
+      glUniform1i(atlasLocation, 0);
+      glUniform2f(tileSizeLocation, float(textureCellSize) / float(atlasWidth), float(textureCellSize) / float(atlasHeight));
+      glBindTexture(GL_TEXTURE_2D, blockTexture);
    }
 
-   // New function prototype:
-   void placeBlock(const Point3D &pos, BlockType type);
-   void initializeWorld(const std::string &worldName)
+   // Disegna il chunk con le coordinate texture (tra begin() ed end()): per chunk cambiano
+   // solo l'origine e il VAO, che contiene già buffer e formato dei vertici impostati in upload().
+   // Le sezioni senza facce vengono saltate; le altre partono ciascuna dal suo primo vertice.
+   void drawTextured(const Chunk &chunk) const
    {
-      currentWorldName = worldName;
-      fs::path worldPath = fs::path("worlds") / worldName;
-      fs::create_directories(worldPath);
-      fs::create_directories(worldPath / "chunks");
-
-      // Save initial world info
-      saveWorldInfo();
-   }
+      if (chunk.vao == 0)
+         return; // Nessun dato caricato
 
-   void saveWorldInfo()
-   {
-      if (currentWorldName.empty())
+      GLsizei counts[SECTIONS_PER_CHUNK];
+      void *offsets[SECTIONS_PER_CHUNK];
+      GLint baseVertices[SECTIONS_PER_CHUNK];
+      GLsizei draws = 0;
+      for (const SectionMesh &mesh : chunk.meshSections)
+      {
+         if (mesh.gpuQuadCount == 0)
+            continue;
+         counts[draws] = static_cast<GLsizei>(mesh.gpuQuadCount * MESH_QUAD_INDICES);
+         offsets[draws] = nullptr;
+         baseVertices[draws] = static_cast<GLint>(mesh.gpuFirstVertex);
+         draws++;
+      }
+      if (draws == 0)
          return;
 
-      fs::path worldPath = fs::path("worlds") / currentWorldName;
-      std::ofstream worldInfo(worldPath / "world.info");
-      worldInfo << "seed " << generationSeed << "\n";
-      worldInfo.close();
+      // I vertici sono relativi al chunk: l'origine porta lo spigolo (0,0,0) nella sua posizione nel mondo
+      glUniform3f(chunkOriginLocation, chunk.pos.x * CHUNK_SIZE, 0.0f, chunk.pos.z * CHUNK_SIZE);
+      glBindVertexArray(chunk.vao);
+      glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts, GL_UNSIGNED_INT, offsets, draws, baseVertices);
    }
 
-   void saveChunk(const Point2D &pos, const Chunk &chunk)
+   // Conclude il disegno dei chunk: bordi, evidenziazione e UI usano la pipeline fissa
+   void end() const
    {
-      if (currentWorldName.empty())
-         return;
-
-      fs::path worldPath = fs::path("worlds") / currentWorldName;
-      std::stringstream chunkFileName;
-      chunkFileName << "chunk_" << pos.x << "_" << pos.z << ".dat";
-
-      std::ofstream chunkFile(worldPath / "chunks" / chunkFileName.str(), std::ios::binary);
-
-      // Save chunk data
-      for (int x = 0; x < CHUNK_SIZE; x++)
-      {
-         for (int z = 0; z < CHUNK_SIZE; z++)
-         {
-            for (int y = 0; y < CHUNK_HEIGHT; y++)
-            {
-               int blockType = static_cast<int>(chunk.blocks[x][z][y].type);
-               chunkFile.write(reinterpret_cast<char *>(&blockType), sizeof(int));
-            }
-         }
-      }
-      chunkFile.close();
+      glBindVertexArray(0);
+      glUseProgram(0);
    }
 
-   // Add this new method to the World class
-   bool loadWorld(const std::string &worldName)
+private:
+   // Quadrilateri coperti all'avvio dall'index buffer condiviso (più di una sezione greedy tipica)
+   static const size_t INITIAL_QUAD_INDICES = 16 * 1024;
+   // Margine minimo, in vertici, dell'intervallo di una sezione non vuota: le modifiche di solito
+   // aggiungono pochi quadrilateri e così non costringono a ridisporre il buffer
+   static const size_t SECTION_SLACK_VERTICES = 32 * MESH_QUAD_VERTICES;
+
+   BufferPool buffers;
+   GLuint quadIndexBuffer = 0;
+   size_t quadIndexCapacity = 0; // Quadrilateri coperti dall'index buffer
+   GLuint program = 0;
+   GLint atlasLocation = -1;
+   GLint tileSizeLocation = -1;
+   GLint chunkOriginLocation = -1;
+   GLint viewProjectionLocation = -1;
+
+   // Ridispone il vertex buffer del chunk (con il suo VAO collegato): ogni sezione non vuota riceve
+   // i suoi vertici più un margine, le sezioni non rigenerate vengono copiate dal buffer precedente
+   void relayout(Chunk &chunk)
    {
-      fs::path worldPath = fs::path("worlds") / worldName;
-      if (!fs::exists(worldPath))
+      std::array<size_t, SECTIONS_PER_CHUNK> firstVertex, capacity;
+      size_t totalVertices = 0;
+      for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
       {
-         std::cerr << "World '" << worldName << "' does not exist." << std::endl;
-         return false;
+         const SectionMesh &mesh = chunk.meshSections[s];
+         size_t vertices = mesh.dirty ? mesh.vertexCount() : mesh.gpuQuadCount * MESH_QUAD_VERTICES;
+         firstVertex[s] = totalVertices;
+         capacity[s] = vertices == 0 ? 0 : vertices + std::max(vertices / 4, SECTION_SLACK_VERTICES);
+         totalVertices += capacity[s];
       }
 
-      // Load world info
-      std::ifstream worldInfo(worldPath / "world.info");
-      std::string token;
-      worldInfo >> token >> generationSeed;
-      worldInfo.close();
-
-      currentWorldName = worldName;
-
-      // Clear existing chunks
-      chunksMap.clear();
-
-      // Load all chunks from the chunks directory
-      fs::path chunksPath = worldPath / "chunks";
-      for (const auto &entry : fs::directory_iterator(chunksPath))
+      size_t bytes = BufferPool::sizeClass(totalVertices * MESH_VERTEX_BYTES);
+      GLuint vbo = buffers.acquire(bytes);
+      if (chunk.vbo != 0)
       {
-         if (entry.path().extension() == ".dat")
+         glBindBuffer(GL_COPY_READ_BUFFER, chunk.vbo);
+         glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+         for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
          {
-            std::string filename = entry.path().filename().string();
-            int x, z;
-            if (sscanf(filename.c_str(), "chunk_%d_%d.dat", &x, &z) == 2)
-            {
-               Point2D chunkPos(x, z);
-               Chunk chunk(chunkPos);
-
-               std::ifstream chunkFile(entry.path(), std::ios::binary);
-               for (int x = 0; x < CHUNK_SIZE; x++)
-               {
-                  for (int z = 0; z < CHUNK_SIZE; z++)
-                  {
-                     for (int y = 0; y < CHUNK_HEIGHT; y++)
-                     {
-                        int blockType;
-                        chunkFile.read(reinterpret_cast<char *>(&blockType), sizeof(int));
-                        chunk.blocks[x][z][y].type = static_cast<BlockType>(blockType);
-                        chunk.blocks[x][z][y].pos = Point3D(
-                            chunkPos.x * CHUNK_SIZE + x,
-                            y,
-                            chunkPos.z * CHUNK_SIZE + z);
-                     }
-                  }
-               }
-               chunk.generateMesh();
-               chunksMap[chunkPos] = chunk;
-               //std::cout << "Chunk " << x << ", " << z << " caricato." << std::endl;
-            }
+            const SectionMesh &mesh = chunk.meshSections[s];
+            if (!mesh.dirty && mesh.gpuQuadCount > 0)
+               glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, mesh.gpuFirstVertex * MESH_VERTEX_BYTES,
+                                   firstVertex[s] * MESH_VERTEX_BYTES, mesh.gpuQuadCount * MESH_QUAD_VERTICES * MESH_VERTEX_BYTES);
          }
+         glBindBuffer(GL_COPY_READ_BUFFER, 0);
+         glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+         buffers.release(chunk.vbo, chunk.vboCapacity);
       }
-
-      //std::cout << "Sono stati caricati " << chunksMap.size() << " chunks da '" << worldName << "'" << std::endl;
-      return true;
-   }
-
-   bool loadChunk(const Point2D &pos, Chunk &chunk)
-   {
-      if (currentWorldName.empty())
-         return false;
-
-      fs::path worldPath = fs::path("worlds") / currentWorldName;
-      std::stringstream chunkFileName;
-      chunkFileName << "chunk_" << pos.x << "_" << pos.z << ".dat";
-
-      std::ifstream chunkFile(worldPath / "chunks" / chunkFileName.str(), std::ios::binary);
-      if (!chunkFile.is_open())
-         return false;
-
-      for (int x = 0; x < CHUNK_SIZE; x++)
+      chunk.vbo = vbo;
+      chunk.vboCapacity = bytes;
+      for (int s = 0; s < SECTIONS_PER_CHUNK; s++)
       {
-         for (int z = 0; z < CHUNK_SIZE; z++)
-         {
-            for (int y = 0; y < CHUNK_HEIGHT; y++)
-            {
-               int blockType;
-               chunkFile.read(reinterpret_cast<char *>(&blockType), sizeof(int));
-               chunk.blocks[x][z][y].type = static_cast<BlockType>(blockType);
-               chunk.blocks[x][z][y].pos = Point3D(
-                   pos.x * CHUNK_SIZE + x,
-                   y,
-                   pos.z * CHUNK_SIZE + z);
-            }
-         }
+         chunk.meshSections[s].gpuFirstVertex = firstVertex[s];
+         chunk.meshSections[s].gpuCapacity = capacity[s];
       }
-      chunkFile.close();
-      chunk.generateMesh();
-      return true;
-   }
-};
 
-void World::placeBlock(const Point3D &pos, BlockType type)
-{
-   // Arrotonda le coordinate della posizione a interi
-   int blockX = static_cast<int>(std::round(pos.x));
-   int blockY = static_cast<int>(std::round(pos.y));
-   int blockZ = static_cast<int>(std::round(pos.z));
-
-   // Calcola le coordinate del chunk usando il floor
-   int chunkX = static_cast<int>(std::floor(blockX / static_cast<float>(CHUNK_SIZE)));
-   int chunkZ = static_cast<int>(std::floor(blockZ / static_cast<float>(CHUNK_SIZE)));
-   Point2D chunkCoords(chunkX, chunkZ);
-
-   auto it = chunksMap.find(chunkCoords);
-   if (it == chunksMap.end())
-   {
-      return;
+      // Un solo attributo intero (location 0): le due parole del vertice impacchettato
+      glBindBuffer(GL_ARRAY_BUFFER, chunk.vbo);
+      glEnableVertexAttribArray(0);
+      glVertexAttribIPointer(0, MESH_VERTEX_WORDS, GL_UNSIGNED_INT, MESH_VERTEX_BYTES, (void *)0);
    }
 
-   // Calcola le coordinate locali all'interno del chunk.
-   int localX = blockX - chunkX * CHUNK_SIZE;
-   int localZ = blockZ - chunkZ * CHUNK_SIZE;
-   int localY = blockY;
-
-   // Controlla i limiti
-   if (localX < 0 || localX >= CHUNK_SIZE ||
-       localZ < 0 || localZ >= CHUNK_SIZE ||
-       localY < 0 || localY >= CHUNK_HEIGHT)
+   // Fa coprire all'index buffer condiviso almeno quadCount quadrilateri, raddoppiandolo se serve.
+   // Il buffer mantiene lo stesso nome quando cresce, quindi i VAO che lo usano restano validi.
+   // Va chiamata con il VAO di un chunk collegato (o nessuno): cambia il collegamento GL_ELEMENT_ARRAY_BUFFER.
+   void reserveQuadIndices(size_t quadCount)
    {
-      return;
+      if (quadCount <= quadIndexCapacity)
+         return;
+      size_t capacity = std::max(quadIndexCapacity, INITIAL_QUAD_INDICES);
+      while (capacity < quadCount)
+         capacity *= 2;
+
+      std::vector<uint32_t> indices(capacity * MESH_QUAD_INDICES);
+      for (size_t quad = 0; quad < capacity; quad++)
+         for (int i = 0; i < MESH_QUAD_INDICES; i++)
+            indices[quad * MESH_QUAD_INDICES + i] = static_cast<uint32_t>(quad * MESH_QUAD_VERTICES) + MESH_QUAD_CORNERS[i];
+
+      if (quadIndexBuffer == 0)
+         glGenBuffers(1, &quadIndexBuffer);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndexBuffer);
+      glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+      quadIndexCapacity = capacity;
    }
 
-   // Aggiorna il blocco nel chunk corrente.
-   it->second.blocks[localX][localZ][localY] = Block(type, Point3D(blockX, blockY, blockZ));
-   it->second.generateMesh();
-   saveChunk(chunkCoords, it->second); // Save the chunk after modification
-
-   // Aggiorna la mesh dei chunk adiacenti se il blocco tocca il bordo.
-   int directions[6][3] = {
-       {-1, 0, 0},
-       {1, 0, 0},
-       {0, 0, -1},
-       {0, 0, 1},
-       {0, -1, 0},
-       {0, 1, 0} // Anche se il cambio verticale potrebbe non influire su facce laterali
-   };
-
-   for (int i = 0; i < 6; i++)
+   // Compila uno shader, terminando il programma con il log in caso di errore
+   static GLuint compileShader(GLenum type, const char *source)
    {
-      int nx = blockX + directions[i][0];
-      // int ny = blockY + directions[i][1];
-      int nz = blockZ + directions[i][2];
-      int neighborChunkX = static_cast<int>(std::floor(nx / static_cast<float>(CHUNK_SIZE)));
-      int neighborChunkZ = static_cast<int>(std::floor(nz / static_cast<float>(CHUNK_SIZE)));
-      // Se il blocco adiacente appartiene ad un chunk diverso, aggiorna la sua mesh.
-      if (neighborChunkX != chunkX || neighborChunkZ != chunkZ)
+      GLuint shader = glCreateShader(type);
+      glShaderSource(shader, 1, &source, nullptr);
+      glCompileShader(shader);
+
+      GLint compiled = GL_FALSE;
+      glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+      if (compiled != GL_TRUE)
       {
-         Point2D neighborCoords(neighborChunkX, neighborChunkZ);
-         auto neighborIt = chunksMap.find(neighborCoords);
-         if (neighborIt != chunksMap.end())
-         {
-            neighborIt->second.generateMesh();
-         }
+         char log[1024];
+         glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+         std::cout << "Errore nella compilazione dello shader dei chunk: " << log << std::endl;
+         exit(EXIT_FAILURE);
       }
+      return shader;
    }
-}
+};
 
 class UIRenderer
 {
@@ -1088,6 +582,7 @@ void loadTextures()
 // ================================
 World world;
 UIRenderer ui;
+ChunkRenderer chunkRenderer;
 bool showChunkBorder = false;
 bool showData = true;
 bool showTopFace = true;
@@ -1098,6 +593,12 @@ int lastMouseX = 0, lastMouseY = 0; // Variabili globali per tracciare la posizi
 // Variabili globali per il calcolo degli FPS
 std::chrono::steady_clock::time_point lastFrameTime = std::chrono::steady_clock::now();
 float fps = 0.0f;
+// Frustum della camera e chunk disegnati/scartati nell'ultimo frame
+Frustum viewFrustum;
+int drawnChunks = 0;
+int culledChunks = 0;
+// Chunk con una mesh rigenerata rimasti fuori dal budget di caricamento dell'ultimo frame
+size_t pendingUploads = 0;
 
 // Aggiungi all'inizio, accanto alle altre variabili globali:
 bool cameraMovementEnabled = false;
@@ -1107,14 +608,22 @@ Point3D previewBlockPos;
 
 BlockType selectedBlockType = BlockType::GRASS; // Tipo di blocco selezionato
 
+// Tempi di avvio: dall'inizio di main al primo frame e all'area visibile completa (stampati una volta)
+std::chrono::steady_clock::time_point startupTime;
+bool firstFrameLogged = false;
+bool visibleAreaLogged = false;
+
 // ================================
 // FUNZIONE PRINCIPALE
 // ================================
 int main(int argc, char **argv)
 {
+   startupTime = std::chrono::steady_clock::now();
    int seed = 1;                            // Default seed value
    std::string worldName = "default_world"; // Default world name
    bool loadExisting = false;
+   bool newWorldRequested = false;
+   bool replaceExisting = false; // --replace: --newworld sostituisce un mondo esistente con lo stesso nome
 
    // Process command line arguments
    for (int i = 1; i < argc; i++)
@@ -1135,6 +644,7 @@ int main(int argc, char **argv)
       else if (arg == "--newworld" && i + 1 < argc)
       {
          worldName = argv[i + 1];
+         newWorldRequested = true;
          i++; // Skip next argument
       }
       else if (arg == "--openworld" && i + 1 < argc)
@@ -1143,8 +653,17 @@ int main(int argc, char **argv)
          loadExisting = true;
          i++; // Skip next argument
       }
+      else if (arg == "--replace")
+      {
+         replaceExisting = true;
+      }
    }
 
+   // Senza --newworld né --openworld il mondo predefinito, se c'è già, viene riaperto
+   if (!loadExisting && !newWorldRequested && World::isValidWorldName(worldName) &&
+       fs::exists(fs::path("worlds") / worldName))
+      loadExisting = true;
+
    glutInit(&argc, argv);
    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
    glutInitWindowSize(400, 300);
@@ -1163,12 +682,14 @@ int main(int argc, char **argv)
    glDisable(GL_LIGHTING);
    glEnable(GL_TEXTURE_2D);
    loadTextures();
-   world.camera.reset();
+   chunkRenderer.init();
+   world.onChunkUnload = [](Chunk &chunk)
+   { chunkRenderer.release(chunk); };
 
    if (loadExisting)
    {
-      // Try to load existing world
-      if (!world.loadWorld(worldName))
+      // Try to load existing world (solo l'area visibile dalla camera salvata)
+      if (!world.loadWorld(worldName, RENDER_DISTANCE))
       {
          std::cerr << "Caricamento del mondo non riuscito." << std::endl;
          return EXIT_FAILURE;
@@ -1176,11 +697,16 @@ int main(int argc, char **argv)
    }
    else
    {
-      // Generate new world
+      // Generate new world: solo il chunk della camera e l'anello attorno prima del primo frame,
+      // il resto dell'area visibile viene generato dal pool a partire dai chunk più vicini
       world.generationSeed = seed;
-      world.initializeWorld(worldName);
-      PerlinNoise noise(world.generationSeed);
-      world.generateChunkGrid(12, noise);
+      if (!world.initializeWorld(worldName, replaceExisting))
+      {
+         std::cerr << "Creazione del mondo non riuscita (--replace per sostituire un mondo esistente)." << std::endl;
+         return EXIT_FAILURE;
+      }
+      world.generateChunkGrid(1);
+      world.resetCamera();
    }
 
    // Rest of initialization
@@ -1260,7 +786,8 @@ void display()
 
    glMatrixMode(GL_PROJECTION);
    glLoadIdentity();
-   gluPerspective(45.0f, 1.0f * glutGet(GLUT_WINDOW_WIDTH) / glutGet(GLUT_WINDOW_HEIGHT), 0.1f, 10000.0f);
+   float aspect = 1.0f * glutGet(GLUT_WINDOW_WIDTH) / glutGet(GLUT_WINDOW_HEIGHT);
+   gluPerspective(FIELD_OF_VIEW, aspect, NEAR_PLANE, FAR_PLANE);
 
    glMatrixMode(GL_MODELVIEW);
    glLoadIdentity();
@@ -1282,46 +809,100 @@ void display()
    // Aggiorna i chunk visibili
    world.updateVisibleChunks(world.camera, RENDER_DISTANCE);
 
-   for (const auto &chunkPair : world.chunksMap)
+   // Piani del frustum con gli stessi parametri di gluPerspective e gluLookAt
+   viewFrustum.update(world.camera, FIELD_OF_VIEW, aspect, NEAR_PLANE, FAR_PLANE);
+   drawnChunks = 0;
+   culledChunks = 0;
+
+   // Carica le mesh rigenerate entro il budget del frame, dai chunk più vicini alla camera:
+   // gli altri restano con la mesh precedente fino ai frame successivi
+   static std::vector<Chunk *> dirtyChunks;
+   dirtyChunks.clear();
+   for (auto &chunkPair : world.chunksMap)
+      if (chunkPair.second.meshDirty)
+         dirtyChunks.push_back(&chunkPair.second);
+   Point2D cameraChunk = world.getChunkCoordinates(world.camera.pos);
+   auto distanceToCamera = [&cameraChunk](const Chunk *chunk)
+   {
+      float dx = chunk->pos.x - cameraChunk.x;
+      float dz = chunk->pos.z - cameraChunk.z;
+      return dx * dx + dz * dz;
+   };
+   std::sort(dirtyChunks.begin(), dirtyChunks.end(), [&](const Chunk *a, const Chunk *b)
+             { return distanceToCamera(a) < distanceToCamera(b); });
+   auto uploadStart = std::chrono::steady_clock::now();
+   size_t uploadedBytes = 0;
+   size_t uploaded = 0;
+   while (uploaded < dirtyChunks.size())
+   {
+      double uploadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - uploadStart).count();
+      if (uploaded > 0 && (uploadedBytes >= UPLOAD_BYTES_PER_FRAME || uploadMs >= UPLOAD_MS_PER_FRAME))
+         break;
+      uploadedBytes += chunkRenderer.upload(*dirtyChunks[uploaded++]);
+   }
+   pendingUploads = dirtyChunks.size() - uploaded;
+
+   // Scarta i chunk interamente fuori dal campo visivo
+   static std::vector<const Chunk *> visibleChunks;
+   visibleChunks.clear();
+   for (auto &chunkPair : world.chunksMap)
    {
       const Chunk &chunk = chunkPair.second;
-      chunk.drawTextured();
 
-      if (showChunkBorder)
+      Point3D chunkMin, chunkMax;
+      chunk.getBounds(chunkMin, chunkMax);
+      if (!viewFrustum.intersectsBox(chunkMin, chunkMax))
       {
-         // Salva lo stato corrente del colore e dei parametri delle linee
-         glPushAttrib(GL_CURRENT_BIT | GL_LINE_BIT);
-
-         glColor3f(0.0f, 0.0f, 0.0f); // Imposta il colore del bordo a nero
-         glLineWidth(2.0f);
-         glBegin(GL_LINES);
-         float lineHeight = static_cast<float>(CHUNK_HEIGHT);
-
-         // Calcola le coordinate globali del bordo del chunk
-         float globX = chunk.pos.x * CHUNK_SIZE;
-         float globZ = chunk.pos.z * CHUNK_SIZE;
-         float xMin = globX - 0.5f;
-         float xMax = globX + CHUNK_SIZE - 0.5f;
-         float zMin = globZ - 0.5f;
-         float zMax = globZ + CHUNK_SIZE - 0.5f;
+         culledChunks++;
+         continue;
+      }
+      drawnChunks++;
+      visibleChunks.push_back(&chunk);
+   }
 
-         // Disegna i 4 pilastri verticali agli angoli
-         glVertex3f(xMin, 0.0f, zMin);
-         glVertex3f(xMin, lineHeight, zMin);
+   // Un solo bind di programma e texture per tutti i chunk visibili
+   chunkRenderer.begin();
+   for (const Chunk *chunk : visibleChunks)
+      chunkRenderer.drawTextured(*chunk);
+   chunkRenderer.end();
+
+   if (showChunkBorder)
+   {
+      // Salva lo stato corrente del colore e dei parametri delle linee
+      glPushAttrib(GL_CURRENT_BIT | GL_LINE_BIT);
 
-         glVertex3f(xMax, 0.0f, zMin);
-         glVertex3f(xMax, lineHeight, zMin);
+      glColor3f(0.0f, 0.0f, 0.0f); // Imposta il colore del bordo a nero
+      glLineWidth(2.0f);
+      glBegin(GL_LINES);
+      for (const Chunk *chunk : visibleChunks)
+      {
+         // Coordinate globali del bordo del chunk (in verticale solo la parte occupata)
+         Point3D chunkMin, chunkMax;
+         chunk->getBounds(chunkMin, chunkMax);
+         float xMin = chunkMin.x;
+         float xMax = chunkMax.x;
+         float yMin = chunkMin.y;
+         float yMax = chunkMax.y;
+         float zMin = chunkMin.z;
+         float zMax = chunkMax.z;
+
+         // Disegna i 4 pilastri verticali agli angoli
+         glVertex3f(xMin, yMin, zMin);
+         glVertex3f(xMin, yMax, zMin);
 
-         glVertex3f(xMax, 0.0f, zMax);
-         glVertex3f(xMax, lineHeight, zMax);
+         glVertex3f(xMax, yMin, zMin);
+         glVertex3f(xMax, yMax, zMin);
 
-         glVertex3f(xMin, 0.0f, zMax);
-         glVertex3f(xMin, lineHeight, zMax);
-         glEnd();
+         glVertex3f(xMax, yMin, zMax);
+         glVertex3f(xMax, yMax, zMax);
 
-         // Ripristina lo stato precedente (incluso il colore corrente)
-         glPopAttrib();
+         glVertex3f(xMin, yMin, zMax);
+         glVertex3f(xMin, yMax, zMax);
       }
+      glEnd();
+
+      // Ripristina lo stato precedente (incluso il colore corrente)
+      glPopAttrib();
    }
 
    // Aggiorna la preview dell'evidenziazione ogni frame
@@ -1399,10 +980,10 @@ void display()
 
       // Disegna il rettangolo
       glBegin(GL_QUADS);
-      glVertex2f(0, glutGet(GLUT_WINDOW_HEIGHT) - 100);   // Alto sinistro
+      glVertex2f(0, glutGet(GLUT_WINDOW_HEIGHT) - 160);   // Alto sinistro
       glVertex2f(0, glutGet(GLUT_WINDOW_HEIGHT));         // Basso sinistro
       glVertex2f(350, glutGet(GLUT_WINDOW_HEIGHT));       // Basso destro
-      glVertex2f(350, glutGet(GLUT_WINDOW_HEIGHT) - 100); // Alto destro
+      glVertex2f(350, glutGet(GLUT_WINDOW_HEIGHT) - 160); // Alto destro
       glEnd();
 
       // Riabilita lo Z-buffer dopo aver disegnato il rettangolo
@@ -1422,6 +1003,12 @@ void display()
       ui.drawText("Chunk corrente: (" + std::to_string(chunkCoords.x) + "," + std::to_string(chunkCoords.z) + ")", Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 60), GLUT_BITMAP_HELVETICA_12);
       ui.drawText("Seed: " + std::to_string(world.generationSeed), Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 75), GLUT_BITMAP_HELVETICA_12);
       ui.drawText("Blocco selezionato: " + blockTypeToString(selectedBlockType) + "(" + std::to_string(static_cast<int>(selectedBlockType)) + ")", Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 90), GLUT_BITMAP_HELVETICA_12);
+      ui.drawText("Chunk disegnati: " + std::to_string(drawnChunks) + ", scartati: " + std::to_string(culledChunks), Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 105), GLUT_BITMAP_HELVETICA_12);
+      const BufferPool &gpuBuffers = chunkRenderer.bufferPool();
+      ui.drawText("Buffer GPU: " + std::to_string(gpuBuffers.liveBufferCount()) + " (" + std::to_string(gpuBuffers.liveBufferBytes() / 1024) + " KB), liberi: " + std::to_string(gpuBuffers.freeBufferCount()) + " (" + std::to_string(gpuBuffers.freeBufferBytes() / 1024) + " KB), indici: " + std::to_string(chunkRenderer.quadIndexBytes() / 1024) + " KB", Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 120), GLUT_BITMAP_HELVETICA_12);
+      ChunkSaveQueue::Stats saves = world.saveStats();
+      ui.drawText("Salvataggi in coda: " + std::to_string(saves.queued) + ", scritti: " + std::to_string(static_cast<int>(saves.bytesPerSecond / 1024.0)) + " KB/s", Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 135), GLUT_BITMAP_HELVETICA_12);
+      ui.drawText("Mesh in preparazione: " + std::to_string(world.pendingMeshCount()) + ", da caricare: " + std::to_string(pendingUploads), Point2D(10, glutGet(GLUT_WINDOW_HEIGHT) - 150), GLUT_BITMAP_HELVETICA_12);
 
       // Ripristina le impostazioni OpenGL
       glPopMatrix();
@@ -1466,6 +1053,25 @@ void display()
    glEnable(GL_TEXTURE_2D);
 
    glutSwapBuffers();
+
+   auto sinceStartup = []
+   { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupTime).count(); };
+   if (!firstFrameLogged)
+   {
+      std::cout << "Primo frame dopo " << sinceStartup() << " ms" << std::endl;
+      firstFrameLogged = true;
+   }
+
+   // Finché l'area visibile non è completa (chunk caricati, mesh generate e caricate sulla GPU)
+   // si continua a disegnare, così i chunk e le mesh preparati dai pool entrano anche senza input
+   if (!world.isVisibleAreaLoaded() || world.pendingMeshCount() > 0 || pendingUploads > 0)
+      glutPostRedisplay();
+   else if (!visibleAreaLogged)
+   {
+      std::cout << "Area visibile completa (" << world.chunksMap.size() << " chunk) dopo "
+                << sinceStartup() << " ms" << std::endl;
+      visibleAreaLogged = true;
+   }
 }
 
 void keyboard(unsigned char key, int, int)
@@ -1483,7 +1089,6 @@ void keyboard(unsigned char key, int, int)
       horizontalStep = 0.5f;
       verticalStep = 1.0f;
    }
-   bool moved = false;
 
    switch (key)
    {
@@ -1520,34 +1125,27 @@ void keyboard(unsigned char key, int, int)
    case 'w':
       world.camera.pos.x += horizontalStep * cos(toRadians(world.camera.rot.yRot));
       world.camera.pos.z += horizontalStep * sin(toRadians(world.camera.rot.yRot));
-      moved = true;
       break;
    case 's':
       world.camera.pos.x -= horizontalStep * cos(toRadians(world.camera.rot.yRot));
       world.camera.pos.z -= horizontalStep * sin(toRadians(world.camera.rot.yRot));
-      moved = true;
       break;
    case 'd':
       world.camera.pos.x -= horizontalStep * sin(toRadians(world.camera.rot.yRot));
       world.camera.pos.z += horizontalStep * cos(toRadians(world.camera.rot.yRot));
-      moved = true;
       break;
    case 'a':
       world.camera.pos.x += horizontalStep * sin(toRadians(world.camera.rot.yRot));
       world.camera.pos.z -= horizontalStep * cos(toRadians(world.camera.rot.yRot));
-      moved = true;
       break;
    case ' ':
       world.camera.pos.y += verticalStep;
-      moved = true;
       break;
    case 'S':
       world.camera.pos.y -= verticalStep;
-      moved = true;
       break;
    case 'r':
-      world.camera.reset();
-      moved = true;
+      world.resetCamera();
       break;
    case 'b':
       showChunkBorder = !showChunkBorder;
@@ -1555,6 +1153,10 @@ void keyboard(unsigned char key, int, int)
    case 'n':
       showData = !showData;
       break;
+   case 'g': // Alterna mesher greedy e mesher a facce singole
+      world.setMeshingMode(world.meshingMode == MeshingMode::GREEDY ? MeshingMode::PER_FACE : MeshingMode::GREEDY);
+      std::cout << "Meshing: " << (world.meshingMode == MeshingMode::GREEDY ? "greedy" : "per faccia") << std::endl;
+      break;
       /*
          case 'o': // Save world
             world.saveWorld("my_world", camera);
@@ -1575,11 +1177,7 @@ void keyboard(unsigned char key, int, int)
       */
    }
 
-   if (moved)
-   {
-      world.updateVisibleChunks(world.camera, RENDER_DISTANCE); // Aggiorna i chunk visibili
-   }
-
+   // I chunk visibili vengono aggiornati da display(), una volta per frame
    glutPostRedisplay();
 }
 
@@ -1712,8 +1310,16 @@ void updateBlockHighlight()
          continue;
       }
 
+      // Sopra la heightmap della colonna o in una sezione tutta d'aria: nessun blocco da leggere
+      const ChunkSection &section = it->second.sectionAt(localY);
+      if (localY > it->second.columnHeight(localX, localZ) || section.isEmpty())
+      {
+         lastAirPos = currentPos;
+         continue;
+      }
+
       // Se troviamo un blocco non vuoto, salviamo la posizione per l'evidenziazione
-      if (it->second.blocks[localX][localZ][localY].type != BlockType::AIR)
+      if (section.get(localX, localY % SECTION_HEIGHT, localZ) != BlockType::AIR)
       {
          foundSurface = true;
          highlightedBlockPos = Point3D(blockX, blockY, blockZ);